@@ -0,0 +1,200 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE E/S VECTORIZADA Y EN LOTES EN XV6
+// ============================================================================
+// Este programa compara operaciones de archivos hechas una por una con
+// las mismas operaciones agrupadas:
+// 1. Crear N archivos pequeños: open/write/close por separado contra
+//    batch() con FILES_PER_BATCH archivos por llamada (una sola trampa
+//    y transacciones del log compartidas)
+// 2. stat() de cada archivo (ulib.stat usa batch: 1 llamada en vez de 3)
+// 3. Escribir un registro de 3 partes: tres write() contra un writev()
+// 4. Borrar los archivos uno por uno contra batch()
+//
+// MÉTRICAS:
+// - Ticks por fase
+// - Llamadas al sistema (getsyscount)
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ batchtest [N]
+// 2. Por defecto N = 200 archivos
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+#include "fcntl.h"
+#include "uio.h"
+
+#define DEFAULT_FILES 200
+#define FILES_PER_BATCH 16      // 3 operaciones por archivo
+#define RECORDS 500             // Registros escritos con write/writev
+
+char data[64];
+char names[FILES_PER_BATCH][8];
+struct batchop ops[BATCHMAX];
+
+// Nombre del archivo i: "<c>NNNN"
+void
+mkname(char *name, char c, int i)
+{
+  name[0] = c;
+  name[1] = '0' + (i / 1000) % 10;
+  name[2] = '0' + (i / 100) % 10;
+  name[3] = '0' + (i / 10) % 10;
+  name[4] = '0' + i % 10;
+  name[5] = 0;
+}
+
+void
+report(char *phase, int ticks, int calls)
+{
+  printf(1, "  %s: %d ticks, %d syscalls\n", phase, ticks, calls - 1);
+}
+
+// Crea los archivos [i, i+k) con prefijo c en un solo batch()
+int
+create_batch(char c, int i, int k)
+{
+  int j, n;
+
+  memset(ops, 0, sizeof(ops));
+  n = 0;
+  for(j = 0; j < k; j++){
+    mkname(names[j], c, i + j);
+    ops[n].op = BOP_OPEN;
+    ops[n].path = names[j];
+    ops[n++].n = O_CREATE|O_WRONLY;
+    ops[n].op = BOP_WRITE;
+    ops[n].fd = -1;
+    ops[n].buf = data;
+    ops[n++].n = sizeof(data);
+    ops[n].op = BOP_CLOSE;
+    ops[n++].fd = -1;
+  }
+  return batch(ops, n) == n;
+}
+
+// Borra los archivos [i, i+k) con prefijo c en un solo batch()
+int
+unlink_batch(char c, int i, int k)
+{
+  int j;
+
+  memset(ops, 0, sizeof(ops));
+  for(j = 0; j < k; j++){
+    mkname(names[j], c, i + j);
+    ops[j].op = BOP_UNLINK;
+    ops[j].path = names[j];
+  }
+  return batch(ops, k) == k;
+}
+
+int
+main(int argc, char *argv[])
+{
+  int n, i, k, fd, start, calls, errors;
+  char name[8];
+  struct stat st;
+  struct iovec iov[3];
+  char head[8], tail[4];
+
+  n = DEFAULT_FILES;
+  if(argc > 1)
+    n = atoi(argv[1]);
+  if(n <= 0 || n > 9999){
+    printf(1, "batchtest: N debe estar entre 1 y 9999\n");
+    exit();
+  }
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE E/S EN LOTES - xv6\n");
+  printf(1, "========================================\n");
+  memset(data, 'b', sizeof(data));
+  errors = 0;
+
+  // FASE 1: Creación
+  printf(1, "Crear %d archivos de %d bytes\n", n, sizeof(data));
+  start = uptime();
+  calls = getsyscount();
+  for(i = 0; i < n; i++){
+    mkname(name, 'a', i);
+    if((fd = open(name, O_CREATE|O_WRONLY)) < 0){
+      errors++;
+      continue;
+    }
+    write(fd, data, sizeof(data));
+    close(fd);
+  }
+  report("open/write/close", uptime() - start, getsyscount() - calls);
+
+  start = uptime();
+  calls = getsyscount();
+  for(i = 0; i < n; i += k){
+    k = n - i < FILES_PER_BATCH ? n - i : FILES_PER_BATCH;
+    if(!create_batch('b', i, k))
+      errors++;
+  }
+  report("batch", uptime() - start, getsyscount() - calls);
+
+  // FASE 2: stat()
+  printf(1, "stat() de %d archivos\n", n);
+  start = uptime();
+  calls = getsyscount();
+  for(i = 0; i < n; i++){
+    mkname(name, 'b', i);
+    if(stat(name, &st) < 0 || st.size != sizeof(data))
+      errors++;
+  }
+  report("stat", uptime() - start, getsyscount() - calls);
+
+  // FASE 3: Registros de 3 partes
+  printf(1, "Escribir %d registros de 3 partes\n", RECORDS);
+  memset(head, 'h', sizeof(head));
+  memset(tail, '\n', sizeof(tail));
+  fd = open("batchlog", O_CREATE|O_WRONLY);
+  start = uptime();
+  calls = getsyscount();
+  for(i = 0; i < RECORDS; i++){
+    write(fd, head, sizeof(head));
+    write(fd, data, sizeof(data));
+    write(fd, tail, sizeof(tail));
+  }
+  report("3 x write", uptime() - start, getsyscount() - calls);
+  iov[0].base = head;
+  iov[0].len = sizeof(head);
+  iov[1].base = data;
+  iov[1].len = sizeof(data);
+  iov[2].base = tail;
+  iov[2].len = sizeof(tail);
+  start = uptime();
+  calls = getsyscount();
+  for(i = 0; i < RECORDS; i++)
+    if(writev(fd, iov, 3) != sizeof(head) + sizeof(data) + sizeof(tail))
+      errors++;
+  report("writev", uptime() - start, getsyscount() - calls);
+  close(fd);
+  unlink("batchlog");
+
+  // FASE 4: Borrado
+  printf(1, "Borrar %d archivos\n", n);
+  start = uptime();
+  calls = getsyscount();
+  for(i = 0; i < n; i++){
+    mkname(name, 'a', i);
+    unlink(name);
+  }
+  report("unlink", uptime() - start, getsyscount() - calls);
+  start = uptime();
+  calls = getsyscount();
+  for(i = 0; i < n; i += k){
+    k = n - i < BATCHMAX ? n - i : BATCHMAX;
+    if(!unlink_batch('b', i, k))
+      errors++;
+  }
+  report("batch", uptime() - start, getsyscount() - calls);
+
+  printf(1, "Errores: %d\n", errors);
+  printf(1, "========================================\n");
+  exit();
+}
@@ -0,0 +1,125 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA PARA ARCHIVOS GRANDES EN XV6
+// ============================================================================
+// Este programa mide el rendimiento del mapeo de bloques de archivos:
+// 1. Escritura secuencial de un archivo de varios MB
+// 2. Lectura secuencial del mismo archivo (verificando su contenido)
+//
+// Con bloques directos + indirecto simple el archivo máximo era de ~70 KB.
+// Con el bloque doble indirecto el límite sube a ~8 MB, y la caché de
+// extents del inode permite leer rangos contiguos sin releer el bloque
+// indirecto en cada bloque de datos.
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ bigfiletest [KB]
+// 2. Por defecto escribe y lee un archivo de 2048 KB
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+#include "fcntl.h"
+#include "fs.h"
+
+#define DEFAULT_KB 2048         // Tamaño por defecto del archivo (KB)
+#define CHUNK 4096              // Bytes por llamada a read/write
+
+char buf[CHUNK];
+
+// Llenar el buffer con un patrón que depende del número de chunk
+void
+fill_chunk(int n)
+{
+  int i;
+  for(i = 0; i < CHUNK; i += 4)
+    *(int*)(buf + i) = n * CHUNK + i;
+}
+
+// Verificar que el buffer contiene el patrón del chunk n
+int
+check_chunk(int n)
+{
+  int i;
+  for(i = 0; i < CHUNK; i += 4)
+    if(*(int*)(buf + i) != n * CHUNK + i)
+      return 0;
+  return 1;
+}
+
+// Imprimir throughput en KB/s (1 tick = ~10 ms)
+void
+print_rate(char *what, int kb, int ticks)
+{
+  if(ticks == 0)
+    ticks = 1;
+  printf(1, "%s: %d KB en %d ticks (~%d KB/s)\n", what, kb, ticks,
+         (kb * 100) / ticks);
+}
+
+int
+main(int argc, char *argv[])
+{
+  int fd, kb, nchunks, i, start, errors;
+
+  kb = DEFAULT_KB;
+  if(argc > 1)
+    kb = atoi(argv[1]);
+  if(kb <= 0 || kb * 1024 / BSIZE > MAXFILE){
+    printf(1, "bigfiletest: tamaño invalido (max %d KB)\n",
+           MAXFILE * BSIZE / 1024);
+    exit();
+  }
+  nchunks = kb * 1024 / CHUNK;
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE ARCHIVOS GRANDES - xv6\n");
+  printf(1, "========================================\n");
+  printf(1, "Tamaño maximo de archivo: %d KB\n", MAXFILE * BSIZE / 1024);
+  printf(1, "Tamaño de la prueba: %d KB\n\n", kb);
+
+  // FASE 1: Escritura secuencial
+  unlink("bigfile.tmp");
+  fd = open("bigfile.tmp", O_CREATE|O_RDWR);
+  if(fd < 0){
+    printf(1, "[ERROR] No se pudo crear bigfile.tmp\n");
+    exit();
+  }
+  start = uptime();
+  for(i = 0; i < nchunks; i++){
+    fill_chunk(i);
+    if(write(fd, buf, CHUNK) != CHUNK){
+      printf(1, "[ERROR] Fallo escritura en chunk %d\n", i);
+      close(fd);
+      unlink("bigfile.tmp");
+      exit();
+    }
+  }
+  close(fd);
+  print_rate("Escritura", kb, uptime() - start);
+
+  // FASE 2: Lectura secuencial y verificación
+  fd = open("bigfile.tmp", O_RDONLY);
+  if(fd < 0){
+    printf(1, "[ERROR] No se pudo abrir bigfile.tmp\n");
+    exit();
+  }
+  errors = 0;
+  start = uptime();
+  for(i = 0; i < nchunks; i++){
+    if(read(fd, buf, CHUNK) != CHUNK){
+      printf(1, "[ERROR] Lectura corta en chunk %d\n", i);
+      errors++;
+      break;
+    }
+    if(!check_chunk(i))
+      errors++;
+  }
+  print_rate("Lectura", kb, uptime() - start);
+  close(fd);
+
+  printf(1, "Errores de verificacion: %d\n", errors);
+  unlink("bigfile.tmp");
+  printf(1, "========================================\n");
+  exit();
+}
@@ -0,0 +1,110 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE LA CONSOLA EN XV6
+// ============================================================================
+// Este programa mide el costo de escribir en la consola:
+// 1. Throughput: escribe N líneas (un write() por línea) y mide el tiempo
+// 2. Distorsión: mide cuánto tarda un cálculo fijo de CPU solo, y luego
+//    mientras otro proceso escribe continuamente en la consola
+//
+// Con uartputc() síncrono cada byte esperaba al UART con cons.lock tomado,
+// así que escribir en la consola robaba tiempo de CPU a todos. Con el
+// buffer circular de transmisión vaciado por la interrupción THRE el
+// write() solo copia los bytes y retorna.
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ consoletest [N]
+// 2. Por defecto N = 200 líneas
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+
+#define DEFAULT_LINES 200
+#define WORK_ITER 20000000      // Iteraciones del cálculo de CPU
+
+char line[] = "consoletest: linea de prueba de 64 bytes .....................\n";
+
+// Cálculo fijo de CPU (igual que en schedtest)
+void
+cpu_work(int iterations)
+{
+  int i, j;
+  volatile int result = 1;
+
+  for(i = 0; i < iterations; i++){
+    for(j = 1; j < 10; j++)
+      result = result * j;
+    result = 1;
+  }
+}
+
+// Escribe n líneas en la consola; retorna los ticks usados
+int
+write_lines(int n)
+{
+  int i, start;
+
+  start = uptime();
+  for(i = 0; i < n; i++)
+    write(1, line, sizeof(line) - 1);
+  return uptime() - start;
+}
+
+// Ticks que tarda cpu_work(WORK_ITER)
+int
+timed_work(void)
+{
+  int start;
+
+  start = uptime();
+  cpu_work(WORK_ITER);
+  return uptime() - start;
+}
+
+int
+main(int argc, char *argv[])
+{
+  int n, ticks, alone, loaded, pid;
+
+  n = DEFAULT_LINES;
+  if(argc > 1)
+    n = atoi(argv[1]);
+  if(n <= 0){
+    printf(1, "consoletest: N debe ser positivo\n");
+    exit();
+  }
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE CONSOLA - xv6\n");
+  printf(1, "========================================\n");
+
+  // FASE 1: Throughput
+  ticks = write_lines(n);
+  printf(1, "\nThroughput: %d bytes en %d ticks", n * (sizeof(line) - 1), ticks);
+  if(ticks > 0)
+    printf(1, " (~%d bytes/s)", n * (sizeof(line) - 1) * 100 / ticks);
+  printf(1, "\n");
+
+  // FASE 2: Distorsión del cálculo de CPU
+  alone = timed_work();
+
+  pid = fork();
+  if(pid < 0){
+    printf(1, "[ERROR] fork fallo\n");
+    exit();
+  }
+  if(pid == 0){
+    for(;;)
+      write_lines(1);
+  }
+  loaded = timed_work();
+  kill(pid);
+  wait();
+
+  printf(1, "\nCalculo de CPU solo: %d ticks\n", alone);
+  printf(1, "Calculo de CPU con consola ocupada: %d ticks\n", loaded);
+  printf(1, "========================================\n");
+  exit();
+}
@@ -8,6 +8,11 @@ struct rtcdate;
 struct spinlock;
 struct sleeplock;
 struct stat;
+struct fsstat;
+struct iovec;
+struct sysinfo;
+struct lockstat;
+struct work;
 struct superblock;
 
 // bio.c
@@ -33,11 +38,21 @@ void            fileinit(void);
 int             fileread(struct file*, char*, int n);
 int             filestat(struct file*, struct stat*);
 int             filewrite(struct file*, char*, int n);
+int             filesend(struct file*, struct file*, int n);
+int             filereadv(struct file*, struct iovec*, int);
+int             filewritev(struct file*, struct iovec*, int);
+int             filewritetx(struct file*, char*, int n);
+
+// futex.c
+void            futexinit(void);
+int             futexwait(uint, uint);
+int             futexwake(uint, int);
 
 // fs.c
 void            readsb(int dev, struct superblock *sb);
 int             dirlink(struct inode*, char*, uint);
 struct inode*   dirlookup(struct inode*, char*, uint*);
+void            fsstat(int, struct fsstat*);
 struct inode*   ialloc(uint, short);
 struct inode*   idup(struct inode*);
 void            iinit(int dev);
@@ -46,6 +61,7 @@ void            iput(struct inode*);
 void            iunlock(struct inode*);
 void            iunlockput(struct inode*);
 void            iupdate(struct inode*);
+void            ncremove(struct inode*, char*);
 int             namecmp(const char*, const char*);
 struct inode*   namei(char*);
 struct inode*   nameiparent(char*, char*);
@@ -66,6 +82,8 @@ void            ioapicinit(void);
 // kalloc.c
 char*           kalloc(void);
 void            kfree(char*);
+char*           kzalloc(void);
+void            kzinit(void);
 void            kinit1(void*, void*);
 void            kinit2(void*, void*);
 
@@ -80,12 +98,19 @@ void            lapiceoi(void);
 void            lapicinit(void);
 void            lapicstartap(uchar, uint);
 void            microdelay(int);
+void            tscinit(void);
+void            sysinfotick(void);
+void            clockread(uint*, uint*);
+extern uint     tscperus;
+extern struct sysinfo *sysinfo;
 
 // log.c
 void            initlog(int dev);
 void            log_write(struct buf*);
 void            begin_op();
+int             begin_opn(int);
 void            end_op();
+void            end_opn(int);
 
 // mp.c
 extern int      ismp;
@@ -103,11 +128,19 @@ int             pipewrite(struct pipe*, char*, int);
 
 //PAGEBREAK: 16
 // proc.c
+int             clone(void(*)(void*), void*, void*);
 int             cpuid(void);
 void            exit(void);
 int             fork(void);
+int             getpriority(int);
 int             growproc(int);
+int             join(void**);
+struct proc*    kthread(char*, void(*)(void*), void*);
+int             boostproc(int);
 int             kill(int);
+int             kstackuse(int);
+int             rtset(int, int, int);
+int             rtwait(void);
 struct cpu*     mycpu(void);
 struct proc*    myproc();
 void            pinit(void);
@@ -115,10 +148,13 @@ void            procdump(void);
 void            scheduler(void) __attribute__((noreturn));
 void            sched(void);
 void            setproc(struct proc*);
+int             setpriority(int, int);
 void            sleep(void*, struct spinlock*);
+void            unboostproc(void);
 void            userinit(void);
 int             wait(void);
 void            wakeup(void*);
+void            wakeupproc(struct proc*, void*);
 void            yield(void);
 
 // swtch.S
@@ -129,6 +165,7 @@ void            acquire(struct spinlock*);
 void            getcallerpcs(void*, uint*);
 int             holding(struct spinlock*);
 void            initlock(struct spinlock*, char*);
+int             lockstats(struct lockstat*, int, int);
 void            release(struct spinlock*);
 void            pushcli(void);
 void            popcli(void);
@@ -169,6 +206,7 @@ extern struct spinlock tickslock;
 void            uartinit(void);
 void            uartintr(void);
 void            uartputc(int);
+void            uartsync(void);
 
 // vm.c
 void            seginit(void);
@@ -181,10 +219,19 @@ void            freevm(pde_t*);
 void            inituvm(pde_t*, char*, uint);
 int             loaduvm(pde_t*, char*, struct inode*, uint, uint);
 pde_t*          copyuvm(pde_t*, uint);
+int             mapsysinfo(pde_t*, char*);
 void            switchuvm(struct proc*);
 void            switchkvm(void);
 int             copyout(pde_t*, uint, void*, uint);
 void            clearpteu(pde_t *pgdir, char *uva);
+char*           kstackalloc(void);
+void            kstackfree(char*);
+int             kstackused(char*);
+int             kstackguard(uint);
+
+// workq.c
+void            workinit(void);
+int             workqueue(struct work*);
 
 // number of elements in fixed-size array
 #define NELEM(x) (sizeof(x)/sizeof((x)[0]))
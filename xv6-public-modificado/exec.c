@@ -19,6 +19,10 @@ exec(char *path, char **argv)
   pde_t *pgdir, *oldpgdir;
   struct proc *curproc = myproc();
 
+  // Other threads would be left running in the old image.
+  if(curproc->leader != curproc || curproc->nthread > 0)
+    return -1;
+
   begin_op();
 
   if((ip = namei(path)) == 0){
@@ -37,6 +41,8 @@ exec(char *path, char **argv)
 
   if((pgdir = setupkvm()) == 0)
     goto bad;
+  if(mapsysinfo(pgdir, curproc->infopage) < 0)
+    goto bad;
 
   // Load program into memory.
   sz = 0;
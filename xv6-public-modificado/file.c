@@ -5,10 +5,13 @@
 #include "types.h"
 #include "defs.h"
 #include "param.h"
+#include "mmu.h"
+#include "proc.h"
 #include "fs.h"
 #include "spinlock.h"
 #include "sleeplock.h"
 #include "file.h"
+#include "uio.h"
 
 struct devsw devsw[NDEV];
 struct {
@@ -125,12 +128,10 @@ filewrite(struct file *f, char *addr, int n)
     return pipewrite(f->pipe, addr, n);
   if(f->type == FD_INODE){
     // write a few blocks at a time to avoid exceeding
-    // the maximum log transaction size, including
-    // i-node, indirect block, allocation blocks,
-    // and 2 blocks of slop for non-aligned writes.
+    // the maximum log transaction size (FILEWRITEMAX).
     // this really belongs lower down, since writei()
     // might be writing a device like the console.
-    int max = ((MAXOPBLOCKS-1-1-2) / 2) * 512;
+    int max = FILEWRITEMAX;
     int i = 0;
     while(i < n){
       int n1 = n - i;
@@ -155,3 +156,99 @@ filewrite(struct file *f, char *addr, int n)
   panic("filewrite");
 }
 
+// Write to i-node file f inside the caller's log transaction.
+// n must be at most FILEWRITEMAX.
+int
+filewritetx(struct file *f, char *addr, int n)
+{
+  int r;
+
+  if(f->writable == 0 || f->type != FD_INODE || n > FILEWRITEMAX)
+    return -1;
+  ilock(f->ip);
+  if((r = writei(f->ip, addr, f->off, n)) > 0)
+    f->off += r;
+  iunlock(f->ip);
+  return r;
+}
+
+// Read into each of the cnt buffers in turn.
+// Stops early at a short read, like read() would.
+int
+filereadv(struct file *f, struct iovec *iov, int cnt)
+{
+  int i, r, total;
+
+  total = 0;
+  for(i = 0; i < cnt; i++){
+    if((r = fileread(f, iov[i].base, iov[i].len)) < 0)
+      return total > 0 ? total : -1;
+    total += r;
+    if(r < iov[i].len)
+      break;
+  }
+  return total;
+}
+
+// Write each of the cnt buffers in turn. An i-node write that
+// fits in FILEWRITEMAX bytes uses a single log transaction.
+int
+filewritev(struct file *f, struct iovec *iov, int cnt)
+{
+  int i, r, total;
+
+  total = 0;
+  for(i = 0; i < cnt; i++)
+    total += iov[i].len;
+  if(f->writable && f->type == FD_INODE && total <= FILEWRITEMAX){
+    begin_op();
+    r = 0;
+    for(total = i = 0; i < cnt && r >= 0; i++)
+      if((r = filewritetx(f, iov[i].base, iov[i].len)) > 0)
+        total += r;
+    end_op();
+    return r < 0 && total == 0 ? -1 : total;
+  }
+
+  total = 0;
+  for(i = 0; i < cnt; i++){
+    if((r = filewrite(f, iov[i].base, iov[i].len)) < 0)
+      return total > 0 ? total : -1;
+    total += r;
+  }
+  return total;
+}
+
+// Move up to n bytes from file in to file out without going
+// through user memory, a page at a time through a kernel buffer.
+// Returns the number of bytes moved (0 at end of file), or -1
+// if nothing could be moved.
+int
+filesend(struct file *out, struct file *in, int n)
+{
+  char *buf;
+  int done, r, w;
+
+  if(in->readable == 0 || out->writable == 0 || n < 0)
+    return -1;
+  if((buf = kalloc()) == 0)
+    return -1;
+  done = r = 0;
+  while(done < n && !myproc()->killed){
+    r = n - done;
+    if(r > PGSIZE)
+      r = PGSIZE;
+    if((r = fileread(in, buf, r)) <= 0)
+      break;
+    if((w = filewrite(out, buf, r)) > 0)
+      done += w;
+    if(w != r){
+      r = -1;
+      break;
+    }
+  }
+  kfree(buf);
+  if(done == 0 && r < 0)
+    return -1;
+  return done;
+}
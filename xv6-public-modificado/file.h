@@ -8,12 +8,21 @@ struct file {
   uint off;
 };
 
+// Most bytes filewrite() puts in one log transaction: the
+// i-node, indirect block, allocation blocks, and 2 blocks of
+// slop for non-aligned writes (the slop also covers the
+// double-indirect block).
+#define FILEWRITEMAX (((MAXOPBLOCKS-1-1-2) / 2) * 512)
+
 
 // in-memory copy of an inode
 struct inode {
   uint dev;           // Device number
   uint inum;          // Inode number
   int ref;            // Reference count
+  struct inode *hnext;  // icache hash chain
+  struct inode *lprev;  // icache LRU list, while ref == 0
+  struct inode *lnext;
   struct sleeplock lock; // protects everything below here
   int valid;          // inode has been read from disk?
 
@@ -22,7 +31,12 @@ struct inode {
   short minor;
   short nlink;
   uint size;
-  uint addrs[NDIRECT+1];
+  uint addrs[NDIRECT+2];
+
+  uint extlbn;        // cached extent: file blocks [extlbn, extlbn+extlen)
+  uint extpbn;        // are the contiguous disk blocks starting at extpbn
+  uint extlen;        // 0 if no extent is cached
+  uint goal;          // where to look for the next block (0: anywhere)
 };
 
 // table mapping major device number to
@@ -1,11 +1,12 @@
 // Test that fork fails gracefully.
-// Tiny executable so that the limit can be filling the proc table.
+// The proc table grows as needed, so this runs until the
+// kernel is out of memory.
 
 #include "types.h"
 #include "stat.h"
 #include "user.h"
 
-#define N  1000
+#define N  10000
 
 void
 printf(int fd, const char *s, ...)
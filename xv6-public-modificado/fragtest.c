@@ -0,0 +1,144 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE FRAGMENTACIÓN DEL DISCO EN XV6
+// ============================================================================
+// Este programa mide cómo se fragmenta el espacio libre del disco después
+// de muchos ciclos de creación y borrado de archivos:
+// 1. En cada ciclo crea NFILES archivos de tamaños pseudo-aleatorios,
+//    escribiéndolos de a dos en paralelo (intercalando los write)
+// 2. Borra la mitad de ellos (los de índice impar)
+// 3. Reporta throughput de escritura y el estado del espacio libre
+//
+// MÉTRICAS (obtenidas con la llamada al sistema fsstat):
+// - Bloques libres
+// - Extents libres: número de tramos de bloques libres contiguos
+// - Extent libre más largo
+//
+// Con balloc original (primer bit libre desde el bloque 0) los archivos
+// escritos en paralelo quedan intercalados bloque a bloque y los huecos
+// se multiplican. Con cursor + goal por inode cada archivo queda contiguo.
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ fragtest
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+#include "fcntl.h"
+
+#define CYCLES 10               // Ciclos de creación/borrado
+#define NFILES 20               // Archivos creados por ciclo (par)
+#define MAXBLOCKS 64            // Tamaño máximo de archivo (bloques de 512)
+
+char buf[512];
+uint seed = 12345;
+
+// Generador pseudo-aleatorio simple (LCG)
+uint
+rnd(void)
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) & 0x7fff;
+}
+
+// Nombre del archivo i del ciclo c: "fXXYY"
+void
+fname(char *name, int c, int i)
+{
+  name[0] = 'f';
+  name[1] = '0' + c / 10;
+  name[2] = '0' + c % 10;
+  name[3] = '0' + i / 10;
+  name[4] = '0' + i % 10;
+  name[5] = 0;
+}
+
+void
+print_fsstat(char *label)
+{
+  struct fsstat st;
+
+  if(fsstat(&st) < 0){
+    printf(1, "[ERROR] fsstat fallo\n");
+    return;
+  }
+  printf(1, "%s: libres %d bloques, %d extents libres, mayor extent %d\n",
+         label, st.nfree, st.nfreeext, st.maxfreeext);
+}
+
+// Crea los archivos i e i+1 del ciclo c escribiendo un bloque en cada uno
+// alternadamente. Retorna el número de bloques escritos.
+int
+write_pair(int c, int i)
+{
+  char na[6], nb[6];
+  int fa, fb, sa, sb, k, total;
+
+  fname(na, c, i);
+  fname(nb, c, i + 1);
+  sa = 1 + rnd() % MAXBLOCKS;
+  sb = 1 + rnd() % MAXBLOCKS;
+  fa = open(na, O_CREATE|O_RDWR);
+  fb = open(nb, O_CREATE|O_RDWR);
+  if(fa < 0 || fb < 0){
+    printf(1, "[ERROR] No se pudo crear %s/%s\n", na, nb);
+    exit();
+  }
+  total = 0;
+  for(k = 0; k < sa || k < sb; k++){
+    if(k < sa && write(fa, buf, sizeof(buf)) == sizeof(buf))
+      total++;
+    if(k < sb && write(fb, buf, sizeof(buf)) == sizeof(buf))
+      total++;
+  }
+  close(fa);
+  close(fb);
+  return total;
+}
+
+int
+main(int argc, char *argv[])
+{
+  int c, i, blocks, start, ticks;
+  char name[6];
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE FRAGMENTACION - xv6\n");
+  printf(1, "========================================\n");
+  printf(1, "%d ciclos, %d archivos por ciclo, hasta %d bloques c/u\n\n",
+         CYCLES, NFILES, MAXBLOCKS);
+  memset(buf, 'x', sizeof(buf));
+  print_fsstat("Inicio");
+
+  for(c = 0; c < CYCLES; c++){
+    blocks = 0;
+    start = uptime();
+    for(i = 0; i < NFILES; i += 2)
+      blocks += write_pair(c, i);
+    ticks = uptime() - start;
+    if(ticks == 0)
+      ticks = 1;
+
+    // Borrar la mitad de los archivos para dejar huecos
+    for(i = 1; i < NFILES; i += 2){
+      fname(name, c, i);
+      unlink(name);
+    }
+
+    printf(1, "Ciclo %d: %d KB escritos en %d ticks (~%d KB/s)\n",
+           c, blocks / 2, ticks, (blocks / 2) * 100 / ticks);
+    print_fsstat("  ");
+  }
+
+  // Limpieza: borrar los archivos que quedaron
+  for(c = 0; c < CYCLES; c++){
+    for(i = 0; i < NFILES; i += 2){
+      fname(name, c, i);
+      unlink(name);
+    }
+  }
+  print_fsstat("Final");
+  printf(1, "========================================\n");
+  exit();
+}
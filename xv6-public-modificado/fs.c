@@ -23,6 +23,8 @@
 
 #define min(a, b) ((a) < (b) ? (a) : (b))
 static void itrunc(struct inode*);
+static void ncinit(void);
+static void ncpurge(uint, uint);
 // there should be one superblock per disk device, but we run with
 // only one device
 struct superblock sb; 
@@ -51,25 +53,89 @@ bzero(int dev, int bno)
 }
 
 // Blocks.
+//
+// balloc keeps a little in-memory state so that it does not
+// have to scan the bitmap from block 0 on every allocation:
+//   * bstate.cursor: the block after the last one handed out.
+//     A file with no allocation goal starts searching here,
+//     so new files are laid out one after another.
+//   * ip->goal: the block after the inode's last allocation.
+//     Several files growing at once each keep their blocks
+//     together instead of interleaving.
+//   * bstate.nfree[g]: free blocks described by bitmap block g.
+//     Full bitmap blocks are skipped without a bread.
+// All of it is protected by bstate.lock and is only a hint;
+// the on-disk bitmap stays authoritative.
+
+#define NBGROUP 2048  // max bitmap blocks (disk of 2048*BPB blocks)
 
-// Allocate a zeroed disk block.
-static uint
-balloc(uint dev)
+struct {
+  struct spinlock lock;
+  uint cursor;
+  uint ngroups;
+  uint nfree[NBGROUP];
+} bstate;
+
+// Build the per-bitmap-block free counts from the on-disk bitmap.
+static void
+binit_alloc(int dev)
 {
-  int b, bi, m;
+  int g, bi;
   struct buf *bp;
 
-  bp = 0;
-  for(b = 0; b < sb.size; b += BPB){
-    bp = bread(dev, BBLOCK(b, sb));
-    for(bi = 0; bi < BPB && b + bi < sb.size; bi++){
+  initlock(&bstate.lock, "bstate");
+  bstate.ngroups = (sb.size + BPB - 1) / BPB;
+  if(bstate.ngroups > NBGROUP)
+    panic("binit_alloc: disk too large");
+  for(g = 0; g < bstate.ngroups; g++){
+    bp = bread(dev, sb.bmapstart + g);
+    bstate.nfree[g] = 0;
+    for(bi = 0; bi < BPB && g*BPB + bi < sb.size; bi++)
+      if((bp->data[bi/8] & (1 << (bi % 8))) == 0)
+        bstate.nfree[g]++;
+    brelse(bp);
+  }
+  bstate.cursor = 0;
+}
+
+// Allocate a zeroed disk block, as close after goal as possible.
+// goal == 0 means no preference: continue from the cursor.
+static uint
+balloc(uint dev, uint goal)
+{
+  int n, g, bi, m;
+  struct buf *bp;
+  uint b;
+
+  acquire(&bstate.lock);
+  if(goal == 0 || goal >= sb.size)
+    goal = bstate.cursor;
+  release(&bstate.lock);
+
+  // Visit every bitmap block once, starting at goal's, and then
+  // the part of goal's block that lies before goal.
+  for(n = 0; n <= bstate.ngroups; n++){
+    g = (goal / BPB + n) % bstate.ngroups;
+    if(bstate.nfree[g] == 0)
+      continue;
+    bp = bread(dev, sb.bmapstart + g);
+    for(bi = (n == 0 ? goal % BPB : 0); bi < BPB && g*BPB + bi < sb.size; bi++){
+      if(bi % 8 == 0 && bp->data[bi/8] == 0xff){  // whole byte in use
+        bi += 7;
+        continue;
+      }
       m = 1 << (bi % 8);
       if((bp->data[bi/8] & m) == 0){  // Is block free?
         bp->data[bi/8] |= m;  // Mark block in use.
         log_write(bp);
         brelse(bp);
-        bzero(dev, b + bi);
-        return b + bi;
+        b = g*BPB + bi;
+        acquire(&bstate.lock);
+        bstate.nfree[g]--;
+        bstate.cursor = b + 1;
+        release(&bstate.lock);
+        bzero(dev, b);
+        return b;
       }
     }
     brelse(bp);
@@ -92,6 +158,9 @@ bfree(int dev, uint b)
   bp->data[bi/8] &= ~m;
   log_write(bp);
   brelse(bp);
+  acquire(&bstate.lock);
+  bstate.nfree[b / BPB]++;
+  release(&bstate.lock);
 }
 
 // Inodes.
@@ -120,9 +189,9 @@ bfree(int dev, uint b)
 //   the reference and link counts have fallen to zero.
 //
 // * Referencing in cache: an entry in the inode cache
-//   is free if ip->ref is zero. Otherwise ip->ref tracks
-//   the number of in-memory pointers to the entry (open
-//   files and current directories). iget() finds or
+//   can be recycled if ip->ref is zero. Otherwise ip->ref
+//   tracks the number of in-memory pointers to the entry
+//   (open files and current directories). iget() finds or
 //   creates a cache entry and increments its ref; iput()
 //   decrements ref.
 //
@@ -130,7 +199,9 @@ bfree(int dev, uint b)
 //   cache entry is only correct when ip->valid is 1.
 //   ilock() reads the inode from
 //   the disk and sets ip->valid, while iput() clears
-//   ip->valid if ip->ref has fallen to zero.
+//   ip->valid if it frees the inode.  An entry whose
+//   ref has fallen to zero keeps its contents, so a
+//   later iget() of the same inode need not read the disk.
 //
 // * Locked: file system code may only examine and modify
 //   the information in an inode and its content if it
@@ -154,31 +225,108 @@ bfree(int dev, uint b)
 // have locked the inodes involved; this lets callers create
 // multi-step atomic operations.
 //
+// The cache starts empty and grows a page of entries at a
+// time, up to NINODE entries.  Cached entries are found through
+// a hash table on (dev, inum).  Entries with ref == 0 are also
+// on an LRU list; once the cache is full, iget() recycles the
+// least recently used of them.
+//
 // The icache.lock spin-lock protects the allocation of icache
 // entries. Since ip->ref indicates whether an entry is free,
 // and ip->dev and ip->inum indicate which i-node an entry
-// holds, one must hold icache.lock while using any of those fields.
+// holds, one must hold icache.lock while using any of those fields,
+// and while using the hash chains and the LRU list.
 //
 // An ip->lock sleep-lock protects all ip-> fields other than ref,
 // dev, and inum.  One must hold ip->lock in order to
 // read or write that inode's ip->valid, ip->size, ip->type, &c.
 
+#define NIHASH 127
+#define IHASH(dev, inum) (((dev) * 31 + (inum)) % NIHASH)
+
 struct {
   struct spinlock lock;
-  struct inode inode[NINODE];
-} icache;
+  struct inode *hash[NIHASH];
+  int n;                // number of entries allocated so far
+  uint hits;
+  uint misses;
+
+  // Linked list of entries with ref == 0, through lprev/lnext.
+  // lru.lnext is most recently used.  Initialized statically
+  // because userinit() calls iget() before iinit() runs.
+  struct inode lru;
+} icache = {
+  .lru = { .lprev = &icache.lru, .lnext = &icache.lru },
+};
+
+// Put ip on the LRU list, at the most recently used end
+// if it may be needed again, at the other end if not.
+static void
+ilruadd(struct inode *ip, int mru)
+{
+  struct inode *head = &icache.lru;
+
+  if(mru){
+    ip->lnext = head->lnext;
+    ip->lprev = head;
+  } else {
+    ip->lnext = head;
+    ip->lprev = head->lprev;
+  }
+  ip->lnext->lprev = ip;
+  ip->lprev->lnext = ip;
+}
+
+static void
+ilruremove(struct inode *ip)
+{
+  ip->lnext->lprev = ip->lprev;
+  ip->lprev->lnext = ip->lnext;
+}
+
+// Remove ip from its hash chain.
+static void
+ihashremove(struct inode *ip)
+{
+  struct inode **pp;
+
+  for(pp = &icache.hash[IHASH(ip->dev, ip->inum)]; *pp; pp = &(*pp)->hnext){
+    if(*pp == ip){
+      *pp = ip->hnext;
+      return;
+    }
+  }
+  panic("ihashremove");
+}
+
+// Add a page of unused entries to the cache.
+// Caller must hold icache.lock.
+static void
+igrow(void)
+{
+  struct inode *ip;
+  char *mem;
+  int i;
+
+  if((mem = kalloc()) == 0)
+    return;
+  memset(mem, 0, PGSIZE);
+  ip = (struct inode*)mem;
+  for(i = 0; i < PGSIZE / sizeof(*ip) && icache.n < NINODE; i++, ip++){
+    initsleeplock(&ip->lock, "inode");
+    ilruadd(ip, 0);
+    icache.n++;
+  }
+}
 
 void
 iinit(int dev)
 {
-  int i = 0;
-  
   initlock(&icache.lock, "icache");
-  for(i = 0; i < NINODE; i++) {
-    initsleeplock(&icache.inode[i].lock, "inode");
-  }
+  ncinit();
 
   readsb(dev, &sb);
+  binit_alloc(dev);
   cprintf("sb: size %d nblocks %d ninodes %d nlog %d logstart %d\
  inodestart %d bmap start %d\n", sb.size, sb.nblocks,
           sb.ninodes, sb.nlog, sb.logstart, sb.inodestart,
@@ -241,31 +389,42 @@ iupdate(struct inode *ip)
 static struct inode*
 iget(uint dev, uint inum)
 {
-  struct inode *ip, *empty;
+  struct inode *ip;
 
   acquire(&icache.lock);
 
   // Is the inode already cached?
-  empty = 0;
-  for(ip = &icache.inode[0]; ip < &icache.inode[NINODE]; ip++){
-    if(ip->ref > 0 && ip->dev == dev && ip->inum == inum){
-      ip->ref++;
+  for(ip = icache.hash[IHASH(dev, inum)]; ip; ip = ip->hnext){
+    if(ip->dev == dev && ip->inum == inum){
+      if(ip->ref++ == 0)
+        ilruremove(ip);
+      icache.hits++;
       release(&icache.lock);
       return ip;
     }
-    if(empty == 0 && ip->ref == 0)    // Remember empty slot.
-      empty = ip;
   }
-
-  // Recycle an inode cache entry.
-  if(empty == 0)
+  icache.misses++;
+
+  // Recycle the least recently used free entry, but grow
+  // the cache instead of evicting a cached inode while
+  // it is still smaller than NINODE.
+  ip = icache.lru.lprev;
+  if(icache.n < NINODE && (ip == &icache.lru || ip->inum != 0)){
+    igrow();
+    ip = icache.lru.lprev;
+  }
+  if(ip == &icache.lru)
     panic("iget: no inodes");
 
-  ip = empty;
+  ilruremove(ip);
+  if(ip->inum != 0)
+    ihashremove(ip);
   ip->dev = dev;
   ip->inum = inum;
   ip->ref = 1;
   ip->valid = 0;
+  ip->hnext = icache.hash[IHASH(dev, inum)];
+  icache.hash[IHASH(dev, inum)] = ip;
   release(&icache.lock);
 
   return ip;
@@ -305,6 +464,8 @@ ilock(struct inode *ip)
     ip->size = dip->size;
     memmove(ip->addrs, dip->addrs, sizeof(ip->addrs));
     brelse(bp);
+    ip->extlen = 0;
+    ip->goal = 0;
     ip->valid = 1;
     if(ip->type == 0)
       panic("ilock: no type");
@@ -338,6 +499,8 @@ iput(struct inode *ip)
     release(&icache.lock);
     if(r == 1){
       // inode has no links and no other references: truncate and free.
+      if(ip->type == T_DIR)
+        ncpurge(ip->dev, ip->inum);
       itrunc(ip);
       ip->type = 0;
       iupdate(ip);
@@ -348,6 +511,8 @@ iput(struct inode *ip)
 
   acquire(&icache.lock);
   ip->ref--;
+  if(ip->ref == 0)
+    ilruadd(ip, ip->valid);
   release(&icache.lock);
 }
 
@@ -365,19 +530,56 @@ iunlockput(struct inode *ip)
 // The content (data) associated with each inode is stored
 // in blocks on the disk. The first NDIRECT block numbers
 // are listed in ip->addrs[].  The next NINDIRECT blocks are
-// listed in block ip->addrs[NDIRECT].
+// listed in block ip->addrs[NDIRECT].  The last NDINDIRECT
+// blocks go through the double-indirect block ip->addrs[NDIRECT+1],
+// which lists NINDIRECT indirect blocks.
+//
+// To avoid re-reading an indirect block for every block of a
+// sequential read or write, bmap remembers the last extent it
+// found: a run of file blocks that map to consecutive disk blocks.
+// Later lookups inside that run need no disk access at all.
+
+// Remember the run of contiguous disk blocks starting at file
+// block bn, whose addresses are a[0], a[1], ... a[n-1].
+static void
+extcache(struct inode *ip, uint bn, uint *a, uint n)
+{
+  uint len;
+
+  for(len = 1; len < n && a[len] == a[0] + len; len++)
+    ;
+  ip->extlbn = bn;
+  ip->extpbn = a[0];
+  ip->extlen = len;
+}
+
+// Allocate a block for ip right after the last one it got.
+static uint
+bmapalloc(struct inode *ip)
+{
+  uint addr;
+
+  addr = balloc(ip->dev, ip->goal);
+  ip->goal = addr + 1;
+  return addr;
+}
 
 // Return the disk block address of the nth block in inode ip.
 // If there is no such block, bmap allocates one.
 static uint
 bmap(struct inode *ip, uint bn)
 {
-  uint addr, *a;
+  uint addr, *a, lbn;
   struct buf *bp;
 
+  if(ip->extlen > 0 && bn >= ip->extlbn && bn - ip->extlbn < ip->extlen)
+    return ip->extpbn + (bn - ip->extlbn);
+  lbn = bn;
+
   if(bn < NDIRECT){
     if((addr = ip->addrs[bn]) == 0)
-      ip->addrs[bn] = addr = balloc(ip->dev);
+      ip->addrs[bn] = addr = bmapalloc(ip);
+    extcache(ip, lbn, &ip->addrs[bn], NDIRECT - bn);
     return addr;
   }
   bn -= NDIRECT;
@@ -385,13 +587,40 @@ bmap(struct inode *ip, uint bn)
   if(bn < NINDIRECT){
     // Load indirect block, allocating if necessary.
     if((addr = ip->addrs[NDIRECT]) == 0)
-      ip->addrs[NDIRECT] = addr = balloc(ip->dev);
+      ip->addrs[NDIRECT] = addr = bmapalloc(ip);
     bp = bread(ip->dev, addr);
     a = (uint*)bp->data;
     if((addr = a[bn]) == 0){
-      a[bn] = addr = balloc(ip->dev);
+      a[bn] = addr = bmapalloc(ip);
       log_write(bp);
     }
+    extcache(ip, lbn, &a[bn], NINDIRECT - bn);
+    brelse(bp);
+    return addr;
+  }
+  bn -= NINDIRECT;
+
+  if(bn < NDINDIRECT){
+    // Load double-indirect block, then the indirect block
+    // it points to, allocating each if necessary.
+    if((addr = ip->addrs[NDIRECT+1]) == 0)
+      ip->addrs[NDIRECT+1] = addr = bmapalloc(ip);
+    bp = bread(ip->dev, addr);
+    a = (uint*)bp->data;
+    if((addr = a[bn / NINDIRECT]) == 0){
+      a[bn / NINDIRECT] = addr = bmapalloc(ip);
+      log_write(bp);
+    }
+    brelse(bp);
+
+    bn %= NINDIRECT;
+    bp = bread(ip->dev, addr);
+    a = (uint*)bp->data;
+    if((addr = a[bn]) == 0){
+      a[bn] = addr = bmapalloc(ip);
+      log_write(bp);
+    }
+    extcache(ip, lbn, &a[bn], NINDIRECT - bn);
     brelse(bp);
     return addr;
   }
@@ -399,6 +628,24 @@ bmap(struct inode *ip, uint bn)
   panic("bmap: out of range");
 }
 
+// Free the indirect block addr and every data block it lists.
+static void
+ifreeind(uint dev, uint addr)
+{
+  int j;
+  struct buf *bp;
+  uint *a;
+
+  bp = bread(dev, addr);
+  a = (uint*)bp->data;
+  for(j = 0; j < NINDIRECT; j++){
+    if(a[j])
+      bfree(dev, a[j]);
+  }
+  brelse(bp);
+  bfree(dev, addr);
+}
+
 // Truncate inode (discard contents).
 // Only called when the inode has no links
 // to it (no directory entries referring to it)
@@ -411,6 +658,9 @@ itrunc(struct inode *ip)
   struct buf *bp;
   uint *a;
 
+  ip->extlen = 0;
+  ip->goal = 0;
+
   for(i = 0; i < NDIRECT; i++){
     if(ip->addrs[i]){
       bfree(ip->dev, ip->addrs[i]);
@@ -419,15 +669,20 @@ itrunc(struct inode *ip)
   }
 
   if(ip->addrs[NDIRECT]){
-    bp = bread(ip->dev, ip->addrs[NDIRECT]);
+    ifreeind(ip->dev, ip->addrs[NDIRECT]);
+    ip->addrs[NDIRECT] = 0;
+  }
+
+  if(ip->addrs[NDIRECT+1]){
+    bp = bread(ip->dev, ip->addrs[NDIRECT+1]);
     a = (uint*)bp->data;
     for(j = 0; j < NINDIRECT; j++){
       if(a[j])
-        bfree(ip->dev, a[j]);
+        ifreeind(ip->dev, a[j]);
     }
     brelse(bp);
-    bfree(ip->dev, ip->addrs[NDIRECT]);
-    ip->addrs[NDIRECT] = 0;
+    bfree(ip->dev, ip->addrs[NDIRECT+1]);
+    ip->addrs[NDIRECT+1] = 0;
   }
 
   ip->size = 0;
@@ -519,6 +774,136 @@ namecmp(const char *s, const char *t)
   return strncmp(s, t, DIRSIZ);
 }
 
+// Name cache.
+//
+// Remembers the result of recent directory lookups,
+// (dev, directory inum, name) -> (inum, offset of the dirent),
+// so that namex() does not have to read every dirent of
+// every directory on the path each time.  inum == 0 is a
+// negative entry: the name is known not to exist.
+//
+// The cache is NCSETS sets of NCWAYS entries; a name can only
+// live in the set its hash selects, and the least recently
+// used entry of the set is replaced.  ncache.lock protects it.
+// Entries of a directory only change while the caller holds
+// that directory's sleep-lock (dirlookup, dirlink, unlink),
+// so the cache cannot disagree with the directory contents.
+
+#define NCSETS 512
+#define NCWAYS 4
+
+struct ncentry {
+  uint dev;
+  uint dinum;         // directory holding the name; 0 if entry unused
+  uint inum;          // 0 for a negative entry
+  uint off;           // offset of the dirent in the directory
+  uint used;          // ncache.clock at last use, for LRU
+  char name[DIRSIZ];
+};
+
+struct {
+  struct spinlock lock;
+  uint clock;
+  uint hits;
+  uint misses;
+  struct ncentry set[NCSETS][NCWAYS];
+} ncache;
+
+static void
+ncinit(void)
+{
+  initlock(&ncache.lock, "ncache");
+}
+
+static struct ncentry*
+ncset(uint dev, uint dinum, char *name)
+{
+  uint h;
+  int i;
+
+  h = dev * 31 + dinum;
+  for(i = 0; i < DIRSIZ && name[i]; i++)
+    h = h * 33 + (uchar)name[i];
+  return ncache.set[h % NCSETS];
+}
+
+// Find name in directory dp.  Returns 1 and fills in
+// *pinum and *poff on a hit, 0 on a miss.
+// Caller must hold ncache.lock.
+static int
+nclookup(struct inode *dp, char *name, uint *pinum, uint *poff)
+{
+  struct ncentry *e;
+  int i;
+
+  e = ncset(dp->dev, dp->inum, name);
+  for(i = 0; i < NCWAYS; i++, e++){
+    if(e->dinum == dp->inum && e->dev == dp->dev && namecmp(e->name, name) == 0){
+      e->used = ++ncache.clock;
+      *pinum = e->inum;
+      *poff = e->off;
+      ncache.hits++;
+      return 1;
+    }
+  }
+  ncache.misses++;
+  return 0;
+}
+
+// Record that name in directory dp refers to inum at offset off
+// (inum == 0: name is not in dp).
+static void
+ncenter(struct inode *dp, char *name, uint inum, uint off)
+{
+  struct ncentry *e, *victim;
+  int i;
+
+  acquire(&ncache.lock);
+  e = ncset(dp->dev, dp->inum, name);
+  victim = e;
+  for(i = 0; i < NCWAYS; i++, e++){
+    if(e->dinum == dp->inum && e->dev == dp->dev && namecmp(e->name, name) == 0){
+      victim = e;
+      break;
+    }
+    if(e->used < victim->used)
+      victim = e;
+  }
+  victim->dev = dp->dev;
+  victim->dinum = dp->inum;
+  victim->inum = inum;
+  victim->off = off;
+  victim->used = ++ncache.clock;
+  strncpy(victim->name, name, DIRSIZ);
+  release(&ncache.lock);
+}
+
+// The dirent for name in dp has been cleared.
+// Caller must hold dp->lock.
+void
+ncremove(struct inode *dp, char *name)
+{
+  ncenter(dp, name, 0, 0);
+}
+
+// Directory inum on dev has been freed: drop all its names,
+// since the inode number may be reused for another directory.
+static void
+ncpurge(uint dev, uint inum)
+{
+  struct ncentry *e;
+  int i, j;
+
+  acquire(&ncache.lock);
+  for(i = 0; i < NCSETS; i++){
+    e = ncache.set[i];
+    for(j = 0; j < NCWAYS; j++, e++)
+      if(e->dinum == inum && e->dev == dev)
+        e->dinum = 0;
+  }
+  release(&ncache.lock);
+}
+
 // Look for a directory entry in a directory.
 // If found, set *poff to byte offset of entry.
 struct inode*
@@ -530,6 +915,17 @@ dirlookup(struct inode *dp, char *name, uint *poff)
   if(dp->type != T_DIR)
     panic("dirlookup not DIR");
 
+  acquire(&ncache.lock);
+  if(nclookup(dp, name, &inum, &off)){
+    release(&ncache.lock);
+    if(inum == 0)
+      return 0;
+    if(poff)
+      *poff = off;
+    return iget(dp->dev, inum);
+  }
+  release(&ncache.lock);
+
   for(off = 0; off < dp->size; off += sizeof(de)){
     if(readi(dp, (char*)&de, off, sizeof(de)) != sizeof(de))
       panic("dirlookup read");
@@ -540,10 +936,12 @@ dirlookup(struct inode *dp, char *name, uint *poff)
       if(poff)
         *poff = off;
       inum = de.inum;
+      ncenter(dp, name, inum, off);
       return iget(dp->dev, inum);
     }
   }
 
+  ncenter(dp, name, 0, 0);
   return 0;
 }
 
@@ -573,6 +971,7 @@ dirlink(struct inode *dp, char *name, uint inum)
   de.inum = inum;
   if(writei(dp, (char*)&de, off, sizeof(de)) != sizeof(de))
     panic("dirlink");
+  ncenter(dp, name, inum, off);
 
   return 0;
 }
@@ -668,3 +1067,45 @@ nameiparent(char *path, char *name)
 {
   return namex(path, 1, name);
 }
+
+//PAGEBREAK!
+// Statistics
+
+// Report file system statistics: free blocks, number of runs
+// of free blocks (free extents), the longest such run, and
+// name and inode cache activity.
+void
+fsstat(int dev, struct fsstat *st)
+{
+  int g, bi;
+  uint run;
+  struct buf *bp;
+
+  memset(st, 0, sizeof(*st));
+  st->size = sb.size;
+  acquire(&ncache.lock);
+  st->nchits = ncache.hits;
+  st->ncmisses = ncache.misses;
+  release(&ncache.lock);
+  acquire(&icache.lock);
+  st->ninode = icache.n;
+  st->ichits = icache.hits;
+  st->icmisses = icache.misses;
+  release(&icache.lock);
+  run = 0;
+  for(g = 0; g < bstate.ngroups; g++){
+    bp = bread(dev, sb.bmapstart + g);
+    for(bi = 0; bi < BPB && g*BPB + bi < sb.size; bi++){
+      if(bp->data[bi/8] & (1 << (bi % 8))){
+        run = 0;
+        continue;
+      }
+      st->nfree++;
+      if(run++ == 0)
+        st->nfreeext++;
+      if(run > st->maxfreeext)
+        st->maxfreeext = run;
+    }
+    brelse(bp);
+  }
+}
@@ -0,0 +1,138 @@
+// Futexes: sleep until another thread wakes an address.
+//
+// A waiter is keyed by the kernel address of the word it waits
+// on, which names the physical location, so threads sharing a
+// page table find each other whatever their user address.
+// Waiters are queued in FIFO order on one of NFUTEX hashed
+// buckets; each bucket's lock also orders the value check in
+// futexwait() against futexwake(), so no wakeup is lost.
+
+#include "types.h"
+#include "defs.h"
+#include "param.h"
+#include "memlayout.h"
+#include "mmu.h"
+#include "proc.h"
+#include "spinlock.h"
+
+#define NFUTEX 64
+
+struct {
+  struct spinlock lock;
+  struct proc *head;
+  struct proc *tail;
+} futexq[NFUTEX];
+
+void
+futexinit(void)
+{
+  int i;
+
+  for(i = 0; i < NFUTEX; i++)
+    initlock(&futexq[i].lock, "futex");
+}
+
+// Kernel address of the word at user address uva, or 0 if uva
+// is not a word-aligned address below p->sz. An aligned word
+// never straddles a page, so one uva2ka() covers all of it.
+static uint*
+futexkey(struct proc *p, uint uva)
+{
+  char *ka;
+
+  if(uva % sizeof(uint) || uva >= p->sz)
+    return 0;
+  if((ka = uva2ka(p->pgdir, (char*)PGROUNDDOWN(uva))) == 0)
+    return 0;
+  return (uint*)(ka + uva % PGSIZE);
+}
+
+static int
+futexhash(uint *key)
+{
+  return ((uint)key >> 2) % NFUTEX;
+}
+
+// Remove p from bucket q. q's lock must be held.
+static void
+futexdequeue(int q, struct proc *p)
+{
+  struct proc **pp;
+
+  for(pp = &futexq[q].head; *pp != p; pp = &(*pp)->futexnext)
+    ;
+  *pp = p->futexnext;
+  if(futexq[q].tail == p){
+    futexq[q].tail = 0;
+    for(p = futexq[q].head; p; p = p->futexnext)
+      futexq[q].tail = p;
+  }
+}
+
+// Sleep while the word at uva holds val. Return 0 when woken
+// by futexwake(), -1 if the value differed or we were killed.
+int
+futexwait(uint uva, uint val)
+{
+  struct proc *p = myproc();
+  uint *key;
+  int q;
+
+  if((key = futexkey(p, uva)) == 0)
+    return -1;
+  q = futexhash(key);
+  acquire(&futexq[q].lock);
+  if(*key != val){
+    release(&futexq[q].lock);
+    return -1;
+  }
+  p->futexkey = key;
+  p->futexnext = 0;
+  if(futexq[q].tail)
+    futexq[q].tail->futexnext = p;
+  else
+    futexq[q].head = p;
+  futexq[q].tail = p;
+
+  while(p->futexkey){
+    if(p->killed){
+      futexdequeue(q, p);
+      p->futexkey = 0;
+      release(&futexq[q].lock);
+      return -1;
+    }
+    sleep(&p->futexkey, &futexq[q].lock);
+  }
+  release(&futexq[q].lock);
+  return 0;
+}
+
+// Wake up to n threads waiting on the word at uva, oldest
+// first. Return how many were woken.
+int
+futexwake(uint uva, int n)
+{
+  struct proc *p, **pp;
+  uint *key;
+  int q, woken;
+
+  if((key = futexkey(myproc(), uva)) == 0)
+    return -1;
+  q = futexhash(key);
+  woken = 0;
+  acquire(&futexq[q].lock);
+  futexq[q].tail = 0;
+  for(pp = &futexq[q].head; (p = *pp) != 0; ){
+    if(p->futexkey == key && woken < n){
+      *pp = p->futexnext;
+      p->futexkey = 0;
+      wakeupproc(p, &p->futexkey);
+      woken++;
+    } else {
+      futexq[q].tail = p;
+      pp = &p->futexnext;
+    }
+  }
+  release(&futexq[q].lock);
+  return woken;
+}
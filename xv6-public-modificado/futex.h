@@ -0,0 +1,3 @@
+// Operations of the futex() system call.
+#define FUTEX_WAIT  0   // sleep if *addr == val
+#define FUTEX_WAKE  1   // wake up to val sleepers on addr
@@ -0,0 +1,153 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE FUTEX EN XV6
+// ============================================================================
+// Este programa compara la sincronización entre hilos con espera activa
+// y con futex(). Con espera activa un hilo que espera un lock gasta su
+// quantum girando, y si el dueño del lock fue desalojado nadie avanza.
+// Con futex el que espera duerme en el kernel (cola por dirección física)
+// y el que libera el lock lo despierta.
+//
+// FASES:
+// 1. T hilos incrementan un contador compartido ITERS veces cada uno,
+//    protegido con un spinlock de usuario (xchg)
+// 2. Lo mismo con el lock de uthread (futex)
+// 3. Dos hilos se pasan un turno ROUNDS veces con variables de
+//    condición (ping-pong)
+//
+// MÉTRICAS:
+// - Tiempo de cada fase (clock(), en us)
+// - Microsegundos por traspaso en el ping-pong
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ futextest [T]
+// 2. Por defecto T = 8 hilos; con más hilos que CPUs la espera activa
+//    empeora mucho
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+#include "x86.h"
+#include "sysinfo.h"
+#include "uthread.h"
+
+#define DEFAULT_T 8
+#define MAXTHREADS 16
+#define ITERS 20000
+#define ROUNDS 2000
+
+volatile int counter;
+volatile uint spinlock;     // Fase 1
+struct lock lk;             // Fases 2 y 3
+struct cond turncv;
+volatile int turn;          // Fase 3: de quién es el turno (0 o 1)
+
+int
+now_us(void)
+{
+  struct clockval cv;
+
+  clock(&cv);
+  return cv.sec * 1000000 + cv.nsec / 1000;
+}
+
+void
+spin_worker(void *arg)
+{
+  int i;
+
+  for(i = 0; i < ITERS; i++){
+    while(xchg(&spinlock, 1) != 0)
+      while(spinlock)
+        pause();
+    counter++;
+    spinlock = 0;
+  }
+}
+
+void
+futex_worker(void *arg)
+{
+  int i;
+
+  for(i = 0; i < ITERS; i++){
+    lock_acquire(&lk);
+    counter++;
+    lock_release(&lk);
+  }
+}
+
+void
+pingpong(void *arg)
+{
+  int me, i;
+
+  me = (int)arg;
+  for(i = 0; i < ROUNDS; i++){
+    lock_acquire(&lk);
+    while(turn != me)
+      cond_wait(&turncv, &lk);
+    turn = 1 - me;
+    cond_signal(&turncv);
+    lock_release(&lk);
+  }
+}
+
+// Corre t hilos con fn y devuelve el tiempo en us
+int
+run(void (*fn)(void*), int t)
+{
+  int k, start;
+
+  start = now_us();
+  for(k = 0; k < t; k++)
+    if(thread_create(fn, (void*)k) < 0)
+      printf(1, "[ERROR] thread_create fallo\n");
+  while(thread_join() >= 0)
+    ;
+  return now_us() - start;
+}
+
+int
+main(int argc, char *argv[])
+{
+  int t, us;
+
+  t = DEFAULT_T;
+  if(argc > 1)
+    t = atoi(argv[1]);
+  if(t < 1 || t > MAXTHREADS){
+    printf(1, "uso: futextest [T], T entre 1 y %d\n", MAXTHREADS);
+    exit();
+  }
+  lock_init(&lk);
+  cond_init(&turncv);
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE FUTEX - xv6\n");
+  printf(1, "========================================\n");
+  printf(1, "%d hilos, %d incrementos cada uno\n\n", t, ITERS);
+
+  // FASE 1: Espera activa
+  counter = 0;
+  us = run(spin_worker, t);
+  printf(1, "Spinlock: %d us (contador %d)\n", us, counter);
+  if(counter != t * ITERS)
+    printf(1, "[ERROR] se esperaba %d\n", t * ITERS);
+
+  // FASE 2: Futex
+  counter = 0;
+  us = run(futex_worker, t);
+  printf(1, "Lock con futex: %d us (contador %d)\n", us, counter);
+  if(counter != t * ITERS)
+    printf(1, "[ERROR] se esperaba %d\n", t * ITERS);
+
+  // FASE 3: Ping-pong con variables de condición
+  turn = 0;
+  us = run(pingpong, 2);
+  printf(1, "Ping-pong: %d traspasos en %d us (%d us c/u)\n",
+         2 * ROUNDS, us, us / (2 * ROUNDS));
+  printf(1, "========================================\n");
+  exit();
+}
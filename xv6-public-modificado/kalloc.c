@@ -5,8 +5,10 @@
 #include "memlayout.h"
 #include "mmu.h"
 #include "spinlock.h"
+#include "workq.h"
 
 void freerange(void *vstart, void *vend);
+static char *zsteal(void);
 extern char end[];
 
 struct run {
@@ -68,8 +70,8 @@ kfree(char *v)
 }
 
 // BEST FIT: Busca el bloque MÁS PEQUEÑO que satisface el tamaño
-char*
-kalloc(void)
+static char*
+kbestfit(void)
 {
   struct run *r, *prev, *best, *best_prev;
 
@@ -111,4 +113,116 @@ kalloc(void)
     release(&kmem.lock);
 
   return (char*)best;
-}
\ No newline at end of file
+}
+
+// Sin bloques libres, devuelve una página de la reserva en cero
+// (ver kzalloc) antes de fallar.
+char*
+kalloc(void)
+{
+  char *p;
+
+  if((p = kbestfit()) == 0)
+    p = zsteal();
+  return p;
+}
+
+// ============================================================================
+// RESERVA DE PÁGINAS EN CERO
+// ============================================================================
+// kzalloc() entrega páginas que el hilo kworker ya puso en cero, así
+// allocuvm() y las tablas de páginas no hacen memset() mientras el
+// proceso espera. Cuando quedan menos de la mitad se encarga rellenar
+// la reserva a la cola de trabajos (workq.c). Si la memoria libre se
+// acaba, kalloc() toma páginas de la reserva, así no quedan hasta
+// ZEROPOOL páginas sin usar mientras fallan fork() o pipe().
+// ============================================================================
+
+#define ZEROPOOL 64           // Páginas en cero guardadas
+
+struct {
+  struct spinlock lock;
+  int use;                    // 0 hasta kzinit(): sin kworker todavía
+  int n;
+  char *page[ZEROPOOL];
+  struct work refill;
+} zpool;
+
+// Rellenar la reserva (corre en el kworker)
+static void
+zrefill(void *arg)
+{
+  char *p;
+
+  for(;;){
+    acquire(&zpool.lock);
+    if(zpool.n >= ZEROPOOL){
+      release(&zpool.lock);
+      return;
+    }
+    release(&zpool.lock);
+
+    if((p = kbestfit()) == 0)    // No robarle a la propia reserva
+      return;
+    memset(p, 0, PGSIZE);
+
+    acquire(&zpool.lock);
+    if(zpool.n < ZEROPOOL){
+      zpool.page[zpool.n++] = p;
+      p = 0;
+    }
+    release(&zpool.lock);
+    if(p){
+      kfree(p);
+      return;
+    }
+  }
+}
+
+// Sacar una página de la reserva, o 0 si está vacía
+static char*
+zsteal(void)
+{
+  char *p;
+
+  if(!zpool.use)
+    return 0;
+  p = 0;
+  acquire(&zpool.lock);
+  if(zpool.n > 0)
+    p = zpool.page[--zpool.n];
+  release(&zpool.lock);
+  return p;
+}
+
+void
+kzinit(void)
+{
+  initlock(&zpool.lock, "zpool");
+  zpool.refill.fn = zrefill;
+  zpool.use = 1;
+  workqueue(&zpool.refill);
+}
+
+// Asignar una página llena de ceros
+char*
+kzalloc(void)
+{
+  char *p;
+  int low;
+
+  p = 0;
+  low = 0;
+  if(zpool.use){
+    acquire(&zpool.lock);
+    if(zpool.n > 0)
+      p = zpool.page[--zpool.n];
+    low = zpool.n < ZEROPOOL / 2;
+    release(&zpool.lock);
+    if(low)
+      workqueue(&zpool.refill);
+  }
+  if(p == 0 && (p = kalloc()) != 0)
+    memset(p, 0, PGSIZE);
+  return p;
+}
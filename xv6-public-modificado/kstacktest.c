@@ -0,0 +1,145 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE LA PILA DEL KERNEL EN XV6
+// ============================================================================
+// Cada proceso tiene una pila de kernel de KSTACKSIZE bytes (varias
+// páginas) con una página de guarda sin mapear debajo: si el kernel se
+// pasa de la pila hay un fallo de página y un panic "kernel stack
+// overflow" en vez de pisar otra memoria sin que nadie se entere. La pila
+// se llena con un patrón al crearla, así que la llamada kstackuse(pid)
+// puede decir cuánto se usó como máximo (marca de agua alta).
+//
+// FASES:
+// 1. Después de exec (el camino más profundo de arrancar un programa)
+// 2. Abrir un archivo a través de DEPTH directorios anidados
+// 3. Escribir un archivo grande (log del sistema de archivos)
+// 4. Un hijo hace lo mismo y se bloquea en un pipe: el padre consulta
+//    su marca de agua con kstackuse(pid)
+//
+// MÉTRICAS:
+// - Bytes de pila de kernel usados y porcentaje de KSTACKSIZE
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ kstacktest
+// 2. Ctrl-P muestra la marca de agua de todos los procesos
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+#include "fcntl.h"
+#include "param.h"
+
+#define DEPTH 16
+#define FILEKB 64
+
+char path[DEPTH * 2 + 8];
+char buf[1024];
+
+void
+report(char *what, int used)
+{
+  if(used < 0){
+    printf(1, "[ERROR] kstackuse fallo\n");
+    return;
+  }
+  printf(1, "%s: %d de %d bytes (%d%%)\n", what, used, KSTACKSIZE,
+         used * 100 / KSTACKSIZE);
+}
+
+// Crea DEPTH directorios anidados y abre un archivo en el último
+void
+deeppath(void)
+{
+  int i, fd;
+  char *p;
+
+  p = path;
+  for(i = 0; i < DEPTH; i++){
+    *p++ = 'k';
+    *p = 0;
+    mkdir(path);
+    *p++ = '/';
+  }
+  strcpy(p, "f");
+  if((fd = open(path, O_CREATE | O_RDWR)) < 0){
+    printf(1, "[ERROR] no se pudo crear %s\n", path);
+    return;
+  }
+  close(fd);
+}
+
+void
+bigfile(void)
+{
+  int i, fd;
+
+  if((fd = open("kstack.tmp", O_CREATE | O_RDWR)) < 0){
+    printf(1, "[ERROR] no se pudo crear kstack.tmp\n");
+    return;
+  }
+  memset(buf, 'k', sizeof(buf));
+  for(i = 0; i < FILEKB; i++)
+    write(fd, buf, sizeof(buf));
+  close(fd);
+}
+
+// Borra el archivo y los directorios, del más profundo al primero
+void
+cleanup(void)
+{
+  int i;
+
+  unlink("kstack.tmp");
+  unlink(path);
+  for(i = DEPTH; i > 0; i--){
+    path[i * 2 - 1] = 0;
+    unlink(path);
+  }
+}
+
+int
+main(int argc, char *argv[])
+{
+  int pid, fds[2];
+  char c;
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE PILA DEL KERNEL - xv6\n");
+  printf(1, "========================================\n");
+
+  // FASE 1: exec
+  report("Despues de exec", kstackuse(0));
+
+  // FASE 2: Ruta profunda
+  deeppath();
+  report("Ruta de 16 directorios", kstackuse(0));
+
+  // FASE 3: Archivo grande
+  bigfile();
+  report("Archivo de 64 KB", kstackuse(0));
+
+  // FASE 4: Consultar a un hijo
+  if(pipe(fds) < 0){
+    printf(1, "[ERROR] pipe fallo\n");
+    exit();
+  }
+  pid = fork();
+  if(pid == 0){
+    close(fds[1]);
+    bigfile();
+    read(fds[0], &c, 1);
+    exit();
+  }
+  close(fds[0]);
+  sleep(10);   // Darle tiempo al hijo a escribir
+  report("Hijo bloqueado en un pipe", kstackuse(pid));
+  close(fds[1]);
+  wait();
+  if(kstackuse(pid) != -1)
+    printf(1, "[ERROR] kstackuse de un proceso recogido\n");
+
+  cleanup();
+  printf(1, "========================================\n");
+  exit();
+}
@@ -9,6 +9,7 @@
 #include "traps.h"
 #include "mmu.h"
 #include "x86.h"
+#include "sysinfo.h"
 
 // Local APIC registers, divided by 4 for use as uint[] indices.
 #define ID      (0x0020/4)   // ID
@@ -120,6 +121,94 @@ microdelay(int us)
 {
 }
 
+// Time-stamp counter calibration and the shared time page.
+
+#define PIT_CH2   0x42      // 8253 timer channel 2 data
+#define PIT_MODE  0x43
+#define PIT_GATE  0x61      // bit 0: channel 2 gate; bit 5: its output
+#define PIT_HZ    1193182
+#define CALMS     10        // calibration interval (ms)
+
+uint tscperus;              // TSC cycles per microsecond, 0 if unknown
+
+static char sysinfopage[PGSIZE] __attribute__((aligned(PGSIZE)));
+struct sysinfo *sysinfo = (struct sysinfo*)sysinfopage;
+static uint tscrem;         // cycles not yet counted in sysinfo->usec
+static uint clocksec;       // seconds since boot at the last tick
+static uint clockusec;      // plus microseconds, < 1000000
+
+// Count TSC cycles while PIT channel 2 counts down CALMS ms.
+void
+tscinit(void)
+{
+  uint t0, t1, n;
+
+  n = PIT_HZ * CALMS / 1000;
+  outb(PIT_GATE, (inb(PIT_GATE) & ~0x02) | 0x01);  // gate on, speaker off
+  outb(PIT_MODE, 0xB0);     // channel 2, lo/hi byte, mode 0
+  outb(PIT_CH2, n & 0xFF);
+  outb(PIT_CH2, n >> 8);    // counting starts here
+  t0 = rdtsc();
+  for(n = 0; !(inb(PIT_GATE) & 0x20) && n < 100000000; n++)
+    ;
+  t1 = rdtsc();
+  if(n < 100000000)
+    tscperus = (t1 - t0) / (CALMS * 1000);
+  sysinfo->tscperus = tscperus;
+  sysinfo->tsc = rdtsc();
+}
+
+// Called by the timer interrupt on CPU 0 after ticks++.
+void
+sysinfotick(void)
+{
+  uint now, us;
+
+  now = rdtsc();
+  sysinfo->seq++;
+  sysinfo->ticks = ticks;
+  if(tscperus){
+    tscrem += now - sysinfo->tsc;
+    us = tscrem / tscperus;
+    tscrem %= tscperus;
+  } else
+    us = 10000;
+  sysinfo->usec += us;
+  sysinfo->tsc = now;
+  sysinfo->seq++;
+
+  clockusec += us;
+  while(clockusec >= 1000000){
+    clockusec -= 1000000;
+    clocksec++;
+  }
+}
+
+// Time since boot in seconds and nanoseconds: the time at the
+// last tick plus the TSC cycles since then.
+void
+clockread(uint *sec, uint *nsec)
+{
+  uint cyc;
+
+  acquire(&tickslock);
+  *sec = clocksec;
+  *nsec = clockusec * 1000;
+  if(tscperus){
+    // Another CPU's TSC may lag CPU 0's slightly.
+    cyc = rdtsc() - sysinfo->tsc;
+    if((int)cyc < 0)
+      cyc = 0;
+    cyc += tscrem;
+    *nsec += cyc / tscperus * 1000 + cyc % tscperus * 1000 / tscperus;
+  }
+  release(&tickslock);
+  while(*nsec >= 1000000000){
+    *nsec -= 1000000000;
+    (*sec)++;
+  }
+}
+
 #define CMOS_PORT    0x70
 #define CMOS_RETURN  0x71
 
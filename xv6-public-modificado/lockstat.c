@@ -0,0 +1,107 @@
+// ============================================================================
+// ESTADÍSTICAS DE LOCKS DEL KERNEL EN XV6
+// ============================================================================
+// Este programa muestra cuánto se usan y cuánto se disputan los spinlocks
+// del kernel (ptable, kmem, bcache, ide, ...). Los locks son ticket locks:
+// cada CPU toma un número y espera su turno, así que se atienden en orden
+// de llegada en vez de competir con xchg.
+//
+// MÉTRICAS (por nombre de lock, obtenidas con la llamada lockstat):
+// - Adquisiciones
+// - Adquisiciones con espera (el lock estaba tomado) y su porcentaje
+// - Vueltas de espera totales
+// - Tiempo máximo con el lock tomado (ciclos de TSC y microsegundos)
+//
+// CÓMO USARLO:
+// 1. $ lockstat              muestra los contadores acumulados
+// 2. $ lockstat -r           los pone en cero
+// 3. $ lockstat cmd [args]   los pone en cero, ejecuta cmd y los muestra
+//    (por ejemplo: lockstat stressfs, lockstat forktest)
+// 4. Ejecutar qemu con CPUS=1, 2 y 4 para comparar la contención
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+#include "param.h"
+#include "lockstat.h"
+#include "sysinfo.h"
+
+struct lockstat ls[NLOCKSTAT];
+
+// Porcentaje a/b sin desbordar a*100
+int
+percent(uint a, uint b)
+{
+  if(b >= 1000000)
+    return a / (b / 100);
+  return a * 100 / b;
+}
+
+void
+show(void)
+{
+  int n, i, j, per;
+  struct lockstat t;
+
+  n = lockstat(ls, NLOCKSTAT, 0);
+  if(n < 0){
+    printf(1, "[ERROR] lockstat fallo\n");
+    return;
+  }
+
+  // Ordenar por adquisiciones con espera (inserción)
+  for(i = 1; i < n; i++){
+    t = ls[i];
+    for(j = i; j > 0 && ls[j-1].ncontend < t.ncontend; j--)
+      ls[j] = ls[j-1];
+    ls[j] = t;
+  }
+
+  per = ((struct sysinfo*)USYSINFO)->tscperus;
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "ESTADISTICAS DE LOCKS - xv6\n");
+  printf(1, "========================================\n");
+  for(i = 0; i < n; i++){
+    if(ls[i].nacquire == 0)
+      continue;
+    printf(1, "%s: %d adquisiciones, %d con espera (%d%%)\n",
+           ls[i].name, ls[i].nacquire, ls[i].ncontend,
+           percent(ls[i].ncontend, ls[i].nacquire));
+    printf(1, "  %d vueltas de espera, retencion maxima %d ciclos",
+           ls[i].nspin, ls[i].maxhold);
+    if(per)
+      printf(1, " (~%d us)", ls[i].maxhold / per);
+    printf(1, "\n");
+  }
+  printf(1, "========================================\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+  int pid;
+
+  if(argc < 2){
+    show();
+    exit();
+  }
+  lockstat(0, 0, 1);
+  if(strcmp(argv[1], "-r") == 0)
+    exit();
+
+  pid = fork();
+  if(pid < 0){
+    printf(1, "[ERROR] fork fallo\n");
+    exit();
+  }
+  if(pid == 0){
+    exec(argv[1], argv + 1);
+    printf(2, "lockstat: exec %s fallo\n", argv[1]);
+    exit();
+  }
+  wait();
+  show();
+  exit();
+}
@@ -0,0 +1,10 @@
+// Lock statistics returned by lockstat(), one entry per lock
+// name. Locks sharing a name (every pipe, every sleep lock)
+// are counted together.
+struct lockstat {
+  char name[16];
+  uint nacquire;     // times acquired
+  uint ncontend;     // acquisitions that found the lock held
+  uint nspin;        // wait-loop iterations
+  uint maxhold;      // longest hold, in TSC cycles
+};
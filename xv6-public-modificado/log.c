@@ -61,6 +61,8 @@ initlog(int dev)
   readsb(dev, &sb);
   log.start = sb.logstart;
   log.size = sb.nlog;
+  if(log.size > LOGSIZE + 1)  // header block + what lh.block[] can hold
+    log.size = LOGSIZE + 1;
   log.dev = dev;
   recover_from_log();
 }
@@ -125,30 +127,51 @@ recover_from_log(void)
 void
 begin_op(void)
 {
+  begin_opn(1);
+}
+
+// like begin_op(), but reserves log space for n operations
+// that will share one transaction (see sys_batch).
+// returns how many were reserved, which may be fewer than n
+// if the log is small; end with end_opn() of that number.
+int
+begin_opn(int n)
+{
+  if(n * MAXOPBLOCKS > log.size - 1)
+    n = (log.size - 1) / MAXOPBLOCKS;
+  if(n < 1)
+    n = 1;
   acquire(&log.lock);
   while(1){
     if(log.committing){
       sleep(&log, &log.lock);
-    } else if(log.lh.n + (log.outstanding+1)*MAXOPBLOCKS > LOGSIZE){
+    } else if(log.lh.n + (log.outstanding+n)*MAXOPBLOCKS > log.size - 1){
       // this op might exhaust log space; wait for commit.
       sleep(&log, &log.lock);
     } else {
-      log.outstanding += 1;
+      log.outstanding += n;
       release(&log.lock);
       break;
     }
   }
+  return n;
 }
 
 // called at the end of each FS system call.
 // commits if this was the last outstanding operation.
 void
 end_op(void)
+{
+  end_opn(1);
+}
+
+void
+end_opn(int n)
 {
   int do_commit = 0;
 
   acquire(&log.lock);
-  log.outstanding -= 1;
+  log.outstanding -= n;
   if(log.committing)
     panic("log.committing");
   if(log.outstanding == 0){
@@ -0,0 +1,179 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE BÚSQUEDA DE NOMBRES EN XV6
+// ============================================================================
+// Este programa mide el costo de open() en un directorio con miles de
+// archivos. Sin caché, dirlookup() lee todas las entradas del directorio
+// hasta encontrar el nombre (O(n) por cada open). Con la caché de nombres
+// del kernel las búsquedas repetidas no leen el directorio.
+//
+// FASES:
+// 1. Crear N archivos en el directorio "lkdir"
+// 2. Abrir cada archivo ROUNDS veces (búsquedas positivas)
+// 3. Abrir N nombres inexistentes dos veces (búsquedas negativas)
+// 4. Recorrer el directorio y hacer stat() de cada archivo (como ls)
+// 5. Borrar todo
+//
+// MÉTRICAS:
+// - Ticks por fase
+// - Aciertos y fallos de la caché de nombres (fsstat)
+// - Aciertos y fallos de la caché de inodes (fsstat)
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ lookuptest [N]
+// 2. Por defecto N = 1000
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+#include "fcntl.h"
+#include "fs.h"
+
+#define DEFAULT_FILES 1000
+#define ROUNDS 3
+
+// Construye "lkdir/<c>NNNN"
+void
+mkname(char *path, char c, int i)
+{
+  strcpy(path, "lkdir/");
+  path[6] = c;
+  path[7] = '0' + (i / 1000) % 10;
+  path[8] = '0' + (i / 100) % 10;
+  path[9] = '0' + (i / 10) % 10;
+  path[10] = '0' + i % 10;
+  path[11] = 0;
+}
+
+// Imprime el tiempo de una fase y la actividad de la caché durante ella
+void
+report(char *phase, int ticks, struct fsstat *before)
+{
+  struct fsstat after;
+
+  fsstat(&after);
+  printf(1, "%s: %d ticks\n", phase, ticks);
+  printf(1, "  nombres: %d aciertos, %d fallos\n",
+         after.nchits - before->nchits, after.ncmisses - before->ncmisses);
+  printf(1, "  inodes: %d aciertos, %d fallos (%d en cache)\n",
+         after.ichits - before->ichits, after.icmisses - before->icmisses,
+         after.ninode);
+}
+
+// Lee las entradas de lkdir y hace stat() de cada una, como ls
+void
+listdir(void)
+{
+  int fd, count;
+  struct dirent de;
+  struct stat s;
+  char path[6 + DIRSIZ + 1];
+
+  if((fd = open("lkdir", O_RDONLY)) < 0){
+    printf(1, "[ERROR] No se pudo abrir lkdir\n");
+    return;
+  }
+  count = 0;
+  strcpy(path, "lkdir/");
+  while(read(fd, &de, sizeof(de)) == sizeof(de)){
+    if(de.inum == 0)
+      continue;
+    memmove(path + 6, de.name, DIRSIZ);
+    path[6 + DIRSIZ] = 0;
+    if(stat(path, &s) >= 0)
+      count++;
+  }
+  close(fd);
+  printf(1, "  %d entradas\n", count);
+}
+
+int
+main(int argc, char *argv[])
+{
+  int n, i, r, fd, start, missing;
+  char path[16];
+  struct fsstat st;
+
+  n = DEFAULT_FILES;
+  if(argc > 1)
+    n = atoi(argv[1]);
+  if(n <= 0 || n > 9999){
+    printf(1, "lookuptest: N debe estar entre 1 y 9999\n");
+    exit();
+  }
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE BUSQUEDA DE NOMBRES - xv6\n");
+  printf(1, "========================================\n");
+  printf(1, "Archivos en el directorio: %d\n\n", n);
+
+  if(mkdir("lkdir") < 0){
+    printf(1, "[ERROR] No se pudo crear lkdir (¿ya existe?)\n");
+    exit();
+  }
+
+  // FASE 1: Crear archivos
+  fsstat(&st);
+  start = uptime();
+  for(i = 0; i < n; i++){
+    mkname(path, 'f', i);
+    fd = open(path, O_CREATE|O_RDWR);
+    if(fd < 0){
+      printf(1, "[ERROR] No se pudo crear %s\n", path);
+      n = i;
+      break;
+    }
+    close(fd);
+  }
+  report("Creacion", uptime() - start, &st);
+
+  // FASE 2: Búsquedas positivas
+  fsstat(&st);
+  start = uptime();
+  for(r = 0; r < ROUNDS; r++){
+    for(i = 0; i < n; i++){
+      mkname(path, 'f', i);
+      fd = open(path, O_RDONLY);
+      if(fd < 0){
+        printf(1, "[ERROR] No se pudo abrir %s\n", path);
+        continue;
+      }
+      close(fd);
+    }
+  }
+  report("open() existentes", uptime() - start, &st);
+
+  // FASE 3: Búsquedas negativas
+  fsstat(&st);
+  missing = 0;
+  start = uptime();
+  for(r = 0; r < 2; r++){
+    for(i = 0; i < n; i++){
+      mkname(path, 'x', i);
+      if(open(path, O_RDONLY) < 0)
+        missing++;
+    }
+  }
+  report("open() inexistentes", uptime() - start, &st);
+  if(missing != 2 * n)
+    printf(1, "[ERROR] %d nombres inexistentes se abrieron\n", 2 * n - missing);
+
+  // FASE 4: Recorrido tipo ls
+  fsstat(&st);
+  start = uptime();
+  listdir();
+  report("ls lkdir", uptime() - start, &st);
+
+  // FASE 5: Limpieza
+  fsstat(&st);
+  start = uptime();
+  for(i = 0; i < n; i++){
+    mkname(path, 'f', i);
+    unlink(path);
+  }
+  unlink("lkdir");
+  report("Borrado", uptime() - start, &st);
+  printf(1, "========================================\n");
+  exit();
+}
@@ -21,12 +21,14 @@ main(void)
   kvmalloc();      // kernel page table
   mpinit();        // detect other processors
   lapicinit();     // interrupt controller
+  tscinit();       // time-stamp counter rate
   seginit();       // segment descriptors
   picinit();       // disable pic
   ioapicinit();    // another interrupt controller
   consoleinit();   // console hardware
   uartinit();      // serial port
   pinit();         // process table
+  futexinit();     // futex wait queues
   tvinit();        // trap vectors
   binit();         // buffer cache
   fileinit();      // file table
@@ -34,6 +36,8 @@ main(void)
   startothers();   // start other processors
   kinit2(P2V(4*1024*1024), P2V(PHYSTOP)); // must come after startothers()
   userinit();      // first user process
+  workinit();      // kernel worker thread
+  kzinit();        // pool of zeroed pages
   mpmain();        // finish this processor's setup
 }
 
@@ -82,7 +86,7 @@ startothers(void)
     // pgdir to use. We cannot use kpgdir yet, because the AP processor
     // is running in low  memory, so we use entrypgdir for the APs too.
     stack = kalloc();
-    *(void**)(code-4) = stack + KSTACKSIZE;
+    *(void**)(code-4) = stack + PGSIZE;
     *(void(**)(void))(code-8) = mpenter;
     *(int**)(code-12) = (void *) V2P(entrypgdir);
 
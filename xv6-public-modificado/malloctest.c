@@ -0,0 +1,125 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE MALLOC EN XV6
+// ============================================================================
+// Este programa mide el rendimiento del malloc de usuario (umalloc.c):
+// 1. Objetos pequeños: mantiene NSLOTS punteros vivos y en cada operación
+//    libera uno al azar y lo reemplaza por otro de tamaño aleatorio
+//    (8 a 512 bytes)
+// 2. Objetos grandes: lo mismo con tamaños de 4 KB a 64 KB
+// 3. Liberación total: verifica que el heap se devuelve al kernel
+//
+// Con la lista libre de K&R cada malloc recorría la lista (primer ajuste)
+// y free nunca devolvía memoria. Con clases de tamaño malloc y free son
+// O(1) para objetos pequeños y el heap se recorta con sbrk negativo.
+//
+// MÉTRICAS:
+// - Operaciones por segundo (malloc + free = 1 operación)
+// - Tamaño del heap (sbrk(0)) con todo asignado y después de liberar
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ malloctest
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+
+#define NSLOTS 1000             // Punteros vivos al mismo tiempo
+#define SMALL_OPS 200000        // Operaciones con objetos pequeños
+#define LARGE_SLOTS 16          // Objetos grandes vivos
+#define LARGE_OPS 2000          // Operaciones con objetos grandes
+
+char *slots[NSLOTS];
+uint seed = 12345;
+
+// Generador pseudo-aleatorio simple (LCG)
+uint
+rnd(void)
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) & 0x7fff;
+}
+
+// Tamaño actual del proceso en KB
+int
+heapkb(void)
+{
+  return (uint)sbrk(0) / 1024;
+}
+
+// Ejecuta ops reemplazos aleatorios en slots[0..n) con tamaños en
+// [min, min+range). Retorna el número de fallos de malloc.
+int
+churn(int n, int ops, uint min, uint range)
+{
+  int i, k, failed;
+  uint size;
+
+  failed = 0;
+  for(i = 0; i < ops; i++){
+    k = rnd() % n;
+    free(slots[k]);
+    size = min + (rnd() * 8) % range;
+    slots[k] = malloc(size);
+    if(slots[k] == 0)
+      failed++;
+    else
+      slots[k][0] = slots[k][size-1] = 1;   // tocar el bloque
+  }
+  return failed;
+}
+
+void
+freeall(int n)
+{
+  int i;
+
+  for(i = 0; i < n; i++){
+    free(slots[i]);
+    slots[i] = 0;
+  }
+}
+
+void
+report(char *phase, int ops, int ticks, int failed)
+{
+  printf(1, "%s: %d ops en %d ticks", phase, ops, ticks);
+  if(ticks > 0)
+    printf(1, " (~%d ops/s)", ops / ticks * 100);
+  printf(1, ", heap %d KB", heapkb());
+  if(failed)
+    printf(1, ", %d fallos", failed);
+  printf(1, "\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+  int start, failed, base;
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE MALLOC - xv6\n");
+  printf(1, "========================================\n");
+  base = heapkb();
+  printf(1, "Heap inicial: %d KB\n\n", base);
+
+  // FASE 1: Objetos pequeños
+  start = uptime();
+  failed = churn(NSLOTS, SMALL_OPS, 8, 504);
+  report("Pequenos (8-512 B)", SMALL_OPS, uptime() - start, failed);
+  freeall(NSLOTS);
+  printf(1, "  despues de liberar: heap %d KB\n", heapkb());
+
+  // FASE 2: Objetos grandes
+  start = uptime();
+  failed = churn(LARGE_SLOTS, LARGE_OPS, 4096, 61440);
+  report("Grandes (4-64 KB)", LARGE_OPS, uptime() - start, failed);
+
+  // FASE 3: Liberación total
+  freeall(LARGE_SLOTS);
+  printf(1, "  despues de liberar: heap %d KB (inicial %d KB)\n",
+         heapkb(), base);
+  printf(1, "========================================\n");
+  exit();
+}
@@ -6,7 +6,7 @@
 // 2. BST BEST FIT (Modificado): Árbol binario de búsqueda - Best Fit
 //
 // MÉTRICAS:
-// - Tiempo de asignación/liberación
+// - Tiempo de asignación/liberación (en microsegundos, con clock())
 // - Fragmentación de memoria
 // - Número de bloques libres
 // - Memoria libre total
@@ -21,6 +21,7 @@
 #include "stat.h"
 #include "user.h"
 #include "param.h"
+#include "sysinfo.h"
 
 #define NUM_ALLOCS 50           // Número de asignaciones a realizar
 #define MAX_CONCURRENT 30       // Máximo de bloques concurrentes
@@ -30,11 +31,16 @@
 // FUNCIONES AUXILIARES
 // ============================================================================
 
-// Obtener tiempo actual en ticks
+// Obtener tiempo actual en microsegundos. Con ticks de 10 ms asignar
+// 50 páginas medía "0 ticks"; clock() tiene resolución de nanosegundos.
+// Las restas siguen siendo correctas aunque el valor dé la vuelta.
 int
 gettime(void)
 {
-  return uptime();
+  struct clockval cv;
+
+  clock(&cv);
+  return cv.sec * 1000000 + cv.nsec / 1000;
 }
 
 // Patrón de escritura simple para verificar integridad
@@ -97,7 +103,7 @@ test_sequential_alloc(void)
   alloc_time = end_time - start_time;
 
   printf(1, "Asignaciones exitosas: %d/%d\n", success_count, NUM_ALLOCS);
-  printf(1, "Tiempo de asignacion: %d ticks\n", alloc_time);
+  printf(1, "Tiempo de asignacion: %d us\n", alloc_time);
 
   // FASE 2: Verificación
   printf(1, "\nVerificando integridad de memoria...\n");
@@ -121,13 +127,13 @@ test_sequential_alloc(void)
   end_time = gettime();
   free_time = end_time - start_time;
 
-  printf(1, "Tiempo de liberacion: %d ticks\n", free_time);
+  printf(1, "Tiempo de liberacion: %d us\n", free_time);
   printf(1, "\nRESUMEN PRUEBA 1:\n");
-  printf(1, "  Asignacion: %d ticks (%d ticks/pagina)\n",
+  printf(1, "  Asignacion: %d us (%d us/pagina)\n",
          alloc_time, success_count > 0 ? alloc_time/success_count : 0);
-  printf(1, "  Liberacion: %d ticks (%d ticks/pagina)\n",
+  printf(1, "  Liberacion: %d us (%d us/pagina)\n",
          free_time, success_count > 0 ? free_time/success_count : 0);
-  printf(1, "  Total: %d ticks\n", alloc_time + free_time);
+  printf(1, "  Total: %d us\n", alloc_time + free_time);
   printf(1, "========================================\n");
 }
 
@@ -211,7 +217,7 @@ test_alternating_pattern(void)
   end_time = gettime();
 
   printf(1, "\nRESUMEN PRUEBA 2:\n");
-  printf(1, "  Tiempo total: %d ticks\n", end_time - start_time);
+  printf(1, "  Tiempo total: %d us\n", end_time - start_time);
   printf(1, "  Operaciones exitosas: asignar=%d, reasignar=%d\n",
          operations, reallocated);
   printf(1, "========================================\n");
@@ -294,8 +300,8 @@ test_stress(void)
   end_time = gettime();
 
   printf(1, "\nRESUMEN PRUEBA 3:\n");
-  printf(1, "  Tiempo total: %d ticks\n", end_time - start_time);
-  printf(1, "  Tiempo promedio por iteracion: %d ticks\n",
+  printf(1, "  Tiempo total: %d us\n", end_time - start_time);
+  printf(1, "  Tiempo promedio por iteracion: %d us\n",
          (end_time - start_time) / STRESS_ITERATIONS);
   printf(1, "  Asignaciones exitosas: %d\n", total_allocs);
   printf(1, "  Asignaciones fallidas: %d\n", failed_allocs);
@@ -383,7 +389,7 @@ test_multiprocess(void)
   end_time = gettime();
 
   printf(1, "\nRESUMEN PRUEBA 4:\n");
-  printf(1, "  Tiempo total: %d ticks\n", end_time - start_time);
+  printf(1, "  Tiempo total: %d us\n", end_time - start_time);
   printf(1, "  Todos los procesos completados\n");
   printf(1, "========================================\n");
 }
@@ -430,7 +436,7 @@ main(int argc, char *argv[])
   printf(1, "================================================\n");
   printf(1, "    RESUMEN FINAL\n");
   printf(1, "================================================\n");
-  printf(1, "Tiempo total de todas las pruebas: %d ticks\n",
+  printf(1, "Tiempo total de todas las pruebas: %d us\n",
          total_end - total_start);
   printf(1, "\n");
   printf(1, "INTERPRETACION:\n");
@@ -4,6 +4,7 @@
 #include <string.h>
 #include <fcntl.h>
 #include <assert.h>
+#include <sys/mman.h>
 
 #define stat xv6_stat  // avoid clash with host struct stat
 #include "types.h"
@@ -15,20 +16,23 @@
 #define static_assert(a, b) do { switch (0) case 0: case (a): ; } while (0)
 #endif
 
-#define NINODES 200
-
 // Disk layout:
 // [ boot block | sb block | log | inode blocks | free bit map | data blocks ]
-
-int nbitmap = FSSIZE/(BSIZE*8) + 1;
-int ninodeblocks = NINODES / IPB + 1;
-int nlog = LOGSIZE;
+//
+// The sizes are taken from the command line (see usage below);
+// the kernel reads all of them back from the super block.
+
+int fssize = FSSIZE;       // Size of the image in blocks (-s)
+int ninodes = 2048;        // Number of inodes (-i)
+int nlog = LOGSIZE + 1;    // Log blocks, including the header (-l)
+int nbitmap;
+int ninodeblocks;
 int nmeta;    // Number of meta blocks (boot, sb, nlog, inode, bitmap)
 int nblocks;  // Number of data blocks
 
 int fsfd;
+uchar *img;   // The image, mapped into memory
 struct superblock sb;
-char zeroes[BSIZE];
 uint freeinode = 1;
 uint freeblock;
 
@@ -64,53 +68,103 @@ xint(uint x)
   return y;
 }
 
+void
+usage(void)
+{
+  fprintf(stderr, "Usage: mkfs [-s blocks] [-i inodes] [-l logblocks] "
+          "fs.img files...\n");
+  exit(1);
+}
+
 int
 main(int argc, char *argv[])
 {
-  int i, cc, fd;
+  int i, cc, fd, opt;
   uint rootino, inum, off;
   struct dirent de;
-  char buf[BSIZE];
+  static char buf[64*BSIZE];
   struct dinode din;
 
 
   static_assert(sizeof(int) == 4, "Integers must be 4 bytes!");
 
-  if(argc < 2){
-    fprintf(stderr, "Usage: mkfs fs.img files...\n");
-    exit(1);
+  while((opt = getopt(argc, argv, "s:i:l:")) != -1){
+    switch(opt){
+    case 's':
+      fssize = atoi(optarg);
+      break;
+    case 'i':
+      ninodes = atoi(optarg);
+      break;
+    case 'l':
+      nlog = atoi(optarg);
+      break;
+    default:
+      usage();
+    }
   }
+  argv += optind - 1;
+  argc -= optind - 1;
+  if(argc < 2)
+    usage();
 
   assert((BSIZE % sizeof(struct dinode)) == 0);
   assert((BSIZE % sizeof(struct dirent)) == 0);
 
+  // dirent.inum is a ushort; the kernel log header holds LOGSIZE
+  // block numbers and a transaction may need MAXOPBLOCKS of them.
+  if(ninodes < 2 || ninodes > 65535){
+    fprintf(stderr, "mkfs: inodes must be between 2 and 65535\n");
+    exit(1);
+  }
+  if(nlog < MAXOPBLOCKS + 2 || nlog > LOGSIZE + 1){
+    fprintf(stderr, "mkfs: log blocks must be between %d and %d\n",
+            MAXOPBLOCKS + 2, LOGSIZE + 1);
+    exit(1);
+  }
+
+  // 1 fs block = 1 disk sector
+  nbitmap = fssize/(BSIZE*8) + 1;
+  ninodeblocks = ninodes / IPB + 1;
+  nmeta = 2 + nlog + ninodeblocks + nbitmap;
+  nblocks = fssize - nmeta;
+  if(nblocks <= 0){
+    fprintf(stderr, "mkfs: %d blocks is too small\n", fssize);
+    exit(1);
+  }
+
   fsfd = open(argv[1], O_RDWR|O_CREAT|O_TRUNC, 0666);
   if(fsfd < 0){
     perror(argv[1]);
     exit(1);
   }
 
-  // 1 fs block = 1 disk sector
-  nmeta = 2 + nlog + ninodeblocks + nbitmap;
-  nblocks = FSSIZE - nmeta;
+  // Extending the empty file zero-fills it without writing every
+  // block; all further block reads and writes go to the mapping.
+  if(ftruncate(fsfd, (off_t)fssize * BSIZE) < 0){
+    perror("ftruncate");
+    exit(1);
+  }
+  img = mmap(0, (size_t)fssize * BSIZE, PROT_READ|PROT_WRITE, MAP_SHARED, fsfd, 0);
+  if(img == MAP_FAILED){
+    perror("mmap");
+    exit(1);
+  }
 
-  sb.size = xint(FSSIZE);
+  sb.size = xint(fssize);
   sb.nblocks = xint(nblocks);
-  sb.ninodes = xint(NINODES);
+  sb.ninodes = xint(ninodes);
   sb.nlog = xint(nlog);
   sb.logstart = xint(2);
   sb.inodestart = xint(2+nlog);
   sb.bmapstart = xint(2+nlog+ninodeblocks);
 
   printf("nmeta %d (boot, super, log blocks %u inode blocks %u, bitmap blocks %u) blocks %d total %d\n",
-         nmeta, nlog, ninodeblocks, nbitmap, nblocks, FSSIZE);
+         nmeta, nlog, ninodeblocks, nbitmap, nblocks, fssize);
 
   freeblock = nmeta;     // the first free block that we can allocate
 
-  for(i = 0; i < FSSIZE; i++)
-    wsect(i, zeroes);
-
-  memset(buf, 0, sizeof(buf));
+  memset(buf, 0, BSIZE);
   memmove(buf, &sb, sizeof(sb));
   wsect(1, buf);
 
@@ -164,20 +218,18 @@ main(int argc, char *argv[])
 
   balloc(freeblock);
 
+  if(munmap(img, (size_t)fssize * BSIZE) < 0 || close(fsfd) < 0){
+    perror(argv[1]);
+    exit(1);
+  }
   exit(0);
 }
 
 void
 wsect(uint sec, void *buf)
 {
-  if(lseek(fsfd, sec * BSIZE, 0) != sec * BSIZE){
-    perror("lseek");
-    exit(1);
-  }
-  if(write(fsfd, buf, BSIZE) != BSIZE){
-    perror("write");
-    exit(1);
-  }
+  assert(sec < fssize);
+  memmove(img + (size_t)sec * BSIZE, buf, BSIZE);
 }
 
 void
@@ -210,14 +262,8 @@ rinode(uint inum, struct dinode *ip)
 void
 rsect(uint sec, void *buf)
 {
-  if(lseek(fsfd, sec * BSIZE, 0) != sec * BSIZE){
-    perror("lseek");
-    exit(1);
-  }
-  if(read(fsfd, buf, BSIZE) != BSIZE){
-    perror("read");
-    exit(1);
-  }
+  assert(sec < fssize);
+  memmove(buf, img + (size_t)sec * BSIZE, BSIZE);
 }
 
 uint
@@ -226,6 +272,7 @@ ialloc(ushort type)
   uint inum = freeinode++;
   struct dinode din;
 
+  assert(inum < ninodes);
   bzero(&din, sizeof(din));
   din.type = xshort(type);
   din.nlink = xshort(1);
@@ -238,16 +285,18 @@ void
 balloc(int used)
 {
   uchar buf[BSIZE];
-  int i;
+  int i, b;
 
   printf("balloc: first %d blocks have been allocated\n", used);
-  assert(used < BSIZE*8);
-  bzero(buf, BSIZE);
-  for(i = 0; i < used; i++){
-    buf[i/8] = buf[i/8] | (0x1 << (i%8));
+  assert(used < fssize);
+  for(b = 0; b * BPB < used; b++){
+    bzero(buf, BSIZE);
+    for(i = 0; i < BPB && b * BPB + i < used; i++){
+      buf[i/8] = buf[i/8] | (0x1 << (i%8));
+    }
+    printf("balloc: write bitmap block at sector %d\n", sb.bmapstart + b);
+    wsect(sb.bmapstart + b, buf);
   }
-  printf("balloc: write bitmap block at sector %d\n", sb.bmapstart);
-  wsect(sb.bmapstart, buf);
 }
 
 #define min(a, b) ((a) < (b) ? (a) : (b))
@@ -260,7 +309,7 @@ iappend(uint inum, void *xp, int n)
   struct dinode din;
   char buf[BSIZE];
   uint indirect[NINDIRECT];
-  uint x;
+  uint x, y, dbn;
 
   rinode(inum, &din);
   off = xint(din.size);
@@ -268,12 +317,16 @@ iappend(uint inum, void *xp, int n)
   while(n > 0){
     fbn = off / BSIZE;
     assert(fbn < MAXFILE);
+    if(freeblock + 3 > fssize){
+      fprintf(stderr, "mkfs: image full, use a larger -s\n");
+      exit(1);
+    }
     if(fbn < NDIRECT){
       if(xint(din.addrs[fbn]) == 0){
         din.addrs[fbn] = xint(freeblock++);
       }
       x = xint(din.addrs[fbn]);
-    } else {
+    } else if(fbn < NDIRECT + NINDIRECT){
       if(xint(din.addrs[NDIRECT]) == 0){
         din.addrs[NDIRECT] = xint(freeblock++);
       }
@@ -283,6 +336,23 @@ iappend(uint inum, void *xp, int n)
         wsect(xint(din.addrs[NDIRECT]), (char*)indirect);
       }
       x = xint(indirect[fbn-NDIRECT]);
+    } else {
+      dbn = fbn - NDIRECT - NINDIRECT;
+      if(xint(din.addrs[NDIRECT+1]) == 0){
+        din.addrs[NDIRECT+1] = xint(freeblock++);
+      }
+      rsect(xint(din.addrs[NDIRECT+1]), (char*)indirect);
+      if(indirect[dbn / NINDIRECT] == 0){
+        indirect[dbn / NINDIRECT] = xint(freeblock++);
+        wsect(xint(din.addrs[NDIRECT+1]), (char*)indirect);
+      }
+      y = xint(indirect[dbn / NINDIRECT]);
+      rsect(y, (char*)indirect);
+      if(indirect[dbn % NINDIRECT] == 0){
+        indirect[dbn % NINDIRECT] = xint(freeblock++);
+        wsect(y, (char*)indirect);
+      }
+      x = xint(indirect[dbn % NINDIRECT]);
     }
     n1 = min(n, (fbn + 1) * BSIZE - off);
     rsect(x, buf);
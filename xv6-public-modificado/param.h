@@ -1,14 +1,19 @@
-#define NPROC        64  // maximum number of processes
-#define KSTACKSIZE 4096  // size of per-process kernel stack
+#define KSTACKSIZE 8192  // size of per-process kernel stack (whole pages)
+#define NKSTACK   16384  // maximum number of kernel stacks (live processes)
 #define NCPU          8  // maximum number of CPUs
+#define NLOCKSTAT    32  // lock names tracked by lockstat()
+#define RTMAXUTIL   900  // CPU real-time processes may reserve (1/1000 of a CPU)
+#define NICEMIN     -20  // nice value with the most CPU
+#define NICEMAX      19  // nice value with the least CPU
 #define NOFILE       16  // open files per process
 #define NFILE       100  // open files per system
-#define NINODE       50  // maximum number of active i-nodes
+#define PIPEPAGES     4  // pages in a pipe's ring buffer
+#define NINODE     2048  // maximum number of cached i-nodes
 #define NDEV         10  // maximum major device number
 #define ROOTDEV       1  // device number of file system root disk
 #define MAXARG       32  // max exec arguments
 #define MAXOPBLOCKS  10  // max # of blocks any FS op writes
-#define LOGSIZE      (MAXOPBLOCKS*3)  // max data blocks in on-disk log
-#define NBUF         (MAXOPBLOCKS*3)  // size of disk block cache
-#define FSSIZE       1000  // size of file system in blocks
+#define LOGSIZE      (MAXOPBLOCKS*6)  // max data blocks in on-disk log
+#define NBUF         (MAXOPBLOCKS*8)  // size of disk block cache
+#define FSSIZE       20000  // default size of file system in blocks (mkfs -s)
 
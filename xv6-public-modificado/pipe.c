@@ -1,6 +1,7 @@
 #include "types.h"
 #include "defs.h"
 #include "param.h"
+#include "memlayout.h"
 #include "mmu.h"
 #include "proc.h"
 #include "fs.h"
@@ -8,21 +9,43 @@
 #include "sleeplock.h"
 #include "file.h"
 
-#define PIPESIZE 512
+#define PIPESIZE (PIPEPAGES*PGSIZE)
 
+// The ring is PIPEPAGES separately allocated pages.
+// A user write bigger than the ring into an empty pipe is not
+// copied into the ring: the writer "loans" its buffer and sleeps,
+// and readers copy straight from the writer's pages (one copy
+// instead of two). Smaller writes stay buffered, so a process
+// can still write to its own pipe and read it back.
 struct pipe {
   struct spinlock lock;
-  char data[PIPESIZE];
+  char *data[PIPEPAGES];
   uint nread;     // number of bytes read
   uint nwrite;    // number of bytes written
   int readopen;   // read fd is still open
   int writeopen;  // write fd is still open
+  pde_t *loanpgdir; // page table of the loaning writer
+  char *loanaddr;   // next loaned byte (user address in loanpgdir)
+  uint loann;       // loaned bytes not yet read
+  uint loanleft;    // bytes a failed loan did not deliver
 };
 
+static void
+pipefree(struct pipe *p)
+{
+  int i;
+
+  for(i = 0; i < PIPEPAGES; i++)
+    if(p->data[i])
+      kfree(p->data[i]);
+  kfree((char*)p);
+}
+
 int
 pipealloc(struct file **f0, struct file **f1)
 {
   struct pipe *p;
+  int i;
 
   p = 0;
   *f0 = *f1 = 0;
@@ -30,6 +53,10 @@ pipealloc(struct file **f0, struct file **f1)
     goto bad;
   if((p = (struct pipe*)kalloc()) == 0)
     goto bad;
+  memset(p, 0, sizeof(*p));
+  for(i = 0; i < PIPEPAGES; i++)
+    if((p->data[i] = kalloc()) == 0)
+      goto bad;
   p->readopen = 1;
   p->writeopen = 1;
   p->nwrite = 0;
@@ -48,7 +75,7 @@ pipealloc(struct file **f0, struct file **f1)
 //PAGEBREAK: 20
  bad:
   if(p)
-    kfree((char*)p);
+    pipefree(p);
   if(*f0)
     fileclose(*f0);
   if(*f1)
@@ -69,20 +96,112 @@ pipeclose(struct pipe *p, int writable)
   }
   if(p->readopen == 0 && p->writeopen == 0){
     release(&p->lock);
-    kfree((char*)p);
+    pipefree(p);
   } else
     release(&p->lock);
 }
 
 //PAGEBREAK: 40
+// Copy n bytes between addr and the ring, starting at byte
+// count pos. Chunks stop at page ends and at the ring's wrap.
+static void
+pipecopy(struct pipe *p, uint pos, char *addr, int n, int toring)
+{
+  uint off, m;
+
+  while(n > 0){
+    off = pos % PIPESIZE;
+    m = PGSIZE - off % PGSIZE;
+    if(m > n)
+      m = n;
+    if(toring)
+      memmove(p->data[off / PGSIZE] + off % PGSIZE, addr, m);
+    else
+      memmove(addr, p->data[off / PGSIZE] + off % PGSIZE, m);
+    pos += m;
+    addr += m;
+    n -= m;
+  }
+}
+
+// Copy up to n bytes from the writer's loaned buffer to addr.
+static int
+pipecopyloan(struct pipe *p, char *addr, int n)
+{
+  char *ka;
+  uint off, m;
+  int i;
+
+  if(n > p->loann)
+    n = p->loann;
+  if(n > PIPESIZE)   // bound the time spent holding p->lock
+    n = PIPESIZE;
+  for(i = 0; i < n; i += m){
+    off = (uint)p->loanaddr % PGSIZE;
+    if((ka = uva2ka(p->loanpgdir, p->loanaddr - off)) == 0)
+      break;
+    m = PGSIZE - off;
+    if(m > n - i)
+      m = n - i;
+    memmove(addr + i, ka + off, m);
+    p->loanaddr += m;
+    p->loann -= m;
+  }
+  if(i < n){
+    // Bad loaned page: end the loan; the writer reports
+    // only the bytes delivered.
+    p->loanleft = p->loann;
+    p->loann = 0;
+  }
+  return i;
+}
+
+// Loan addr[0..n) to readers and wait until they have copied it.
+// Called with p->lock held and the ring empty; releases it.
+// Returns the number of bytes delivered, or -1.
+static int
+pipeloan(struct pipe *p, char *addr, int n)
+{
+  p->loanpgdir = myproc()->pgdir;
+  p->loanaddr = addr;
+  p->loann = n;
+  p->loanleft = 0;
+  while(p->loann > 0){
+    if(p->readopen == 0 || myproc()->killed){
+      p->loann = 0;
+      p->loanpgdir = 0;
+      wakeup(&p->nwrite);
+      release(&p->lock);
+      return -1;
+    }
+    wakeup(&p->nread);
+    sleep(&p->nwrite, &p->lock);
+  }
+  n -= p->loanleft;
+  p->loanpgdir = 0;
+  wakeup(&p->nwrite);   // other writers wait for the loan to end
+  release(&p->lock);
+  return n > 0 ? n : -1;
+}
+
 int
 pipewrite(struct pipe *p, char *addr, int n)
 {
-  int i;
+  int i, m;
 
   acquire(&p->lock);
-  for(i = 0; i < n; i++){
-    while(p->nwrite == p->nread + PIPESIZE){  //DOC: pipewrite-full
+  while(p->loanpgdir){
+    if(p->readopen == 0 || myproc()->killed){
+      release(&p->lock);
+      return -1;
+    }
+    sleep(&p->nwrite, &p->lock);
+  }
+  if(n > PIPESIZE && (uint)addr < KERNBASE && p->nread == p->nwrite)
+    return pipeloan(p, addr, n);
+
+  for(i = 0; i < n; i += m){
+    while(p->nwrite == p->nread + PIPESIZE || p->loanpgdir){  //DOC: pipewrite-full
       if(p->readopen == 0 || myproc()->killed){
         release(&p->lock);
         return -1;
@@ -90,7 +209,11 @@ pipewrite(struct pipe *p, char *addr, int n)
       wakeup(&p->nread);
       sleep(&p->nwrite, &p->lock);  //DOC: pipewrite-sleep
     }
-    p->data[p->nwrite++ % PIPESIZE] = addr[i];
+    m = PIPESIZE - (p->nwrite - p->nread);
+    if(m > n - i)
+      m = n - i;
+    pipecopy(p, p->nwrite, addr + i, m, 1);
+    p->nwrite += m;
   }
   wakeup(&p->nread);  //DOC: pipewrite-wakeup1
   release(&p->lock);
@@ -100,22 +223,30 @@ pipewrite(struct pipe *p, char *addr, int n)
 int
 piperead(struct pipe *p, char *addr, int n)
 {
-  int i;
+  int m;
 
   acquire(&p->lock);
-  while(p->nread == p->nwrite && p->writeopen){  //DOC: pipe-empty
+again:
+  while(p->nread == p->nwrite && p->loann == 0 && p->writeopen){  //DOC: pipe-empty
     if(myproc()->killed){
       release(&p->lock);
       return -1;
     }
     sleep(&p->nread, &p->lock); //DOC: piperead-sleep
   }
-  for(i = 0; i < n; i++){  //DOC: piperead-copy
-    if(p->nread == p->nwrite)
-      break;
-    addr[i] = p->data[p->nread++ % PIPESIZE];
+  if(p->loann > 0){
+    if((m = pipecopyloan(p, addr, n)) == 0 && p->loann == 0){
+      wakeup(&p->nwrite);   // the loan failed; 0 would look like EOF
+      goto again;
+    }
+  } else {
+    m = p->nwrite - p->nread;  //DOC: piperead-copy
+    if(m > n)
+      m = n;
+    pipecopy(p, p->nread, addr, m, 0);
+    p->nread += m;
   }
   wakeup(&p->nwrite);  //DOC: piperead-wakeup
   release(&p->lock);
-  return i;
+  return m;
 }
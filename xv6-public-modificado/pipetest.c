@@ -0,0 +1,97 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE THROUGHPUT DE PIPES EN XV6
+// ============================================================================
+// Este programa mide la velocidad de un pipe entre dos procesos:
+// el padre escribe TOTAL_MB megabytes y el hijo los lee, con bloques
+// de distintos tamaños.
+//
+// Con el buffer original de 512 bytes copiado byte a byte, escritor y
+// lector se despertaban mutuamente cada 512 bytes. Con el anillo de
+// varias páginas y copias en bloque hay muchos menos cambios de contexto,
+// y las escrituras grandes se copian directamente del buffer del
+// escritor al del lector (préstamo de páginas).
+//
+// MÉTRICAS:
+// - Throughput en KB/s
+// - Cambios de contexto por MB (escritor + lector, con getcswitch)
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ pipetest
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+
+#define TOTAL_MB 8              // Megabytes transferidos por medición
+#define MAXCHUNK 65536
+
+char buf[MAXCHUNK];
+int sizes[] = { 512, 4096, 65536 };
+
+// Transfiere TOTAL_MB con bloques de chunk bytes
+void
+run(int chunk)
+{
+  int data[2], back[2], total, n, start, ticks, sw, childsw;
+
+  if(pipe(data) < 0 || pipe(back) < 0){
+    printf(1, "[ERROR] pipe fallo\n");
+    exit();
+  }
+
+  start = uptime();
+  sw = getcswitch();
+  if(fork() == 0){
+    // Lector: cuenta bytes y devuelve sus cambios de contexto
+    close(data[1]);
+    close(back[0]);
+    sw = getcswitch();
+    total = 0;
+    while((n = read(data[0], buf, chunk)) > 0)
+      total += n;
+    if(total != TOTAL_MB * 1024 * 1024)
+      printf(1, "[ERROR] el lector recibio %d bytes\n", total);
+    sw = getcswitch() - sw;
+    write(back[1], &sw, sizeof(sw));
+    exit();
+  }
+  close(data[0]);
+  close(back[1]);
+  for(total = 0; total < TOTAL_MB * 1024 * 1024; total += chunk){
+    if(write(data[1], buf, chunk) != chunk){
+      printf(1, "[ERROR] write fallo\n");
+      break;
+    }
+  }
+  close(data[1]);
+  sw = getcswitch() - sw;
+  if(read(back[0], &childsw, sizeof(childsw)) != sizeof(childsw))
+    childsw = 0;
+  close(back[0]);
+  wait();
+  ticks = uptime() - start;
+  if(ticks == 0)
+    ticks = 1;
+
+  printf(1, "Bloques de %d B: %d ticks (~%d KB/s), %d cambios de contexto/MB\n",
+         chunk, ticks, TOTAL_MB * 1024 * 100 / ticks,
+         (sw + childsw) / TOTAL_MB);
+}
+
+int
+main(int argc, char *argv[])
+{
+  int i;
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE PIPES - xv6\n");
+  printf(1, "========================================\n");
+  printf(1, "%d MB por medicion\n\n", TOTAL_MB);
+  memset(buf, 'p', sizeof(buf));
+  for(i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++)
+    run(sizes[i]);
+  printf(1, "========================================\n");
+  exit();
+}
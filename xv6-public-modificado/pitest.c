@@ -0,0 +1,169 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE INVERSIÓN DE PRIORIDAD EN XV6
+// ============================================================================
+// Un proceso de cola baja (L) escribe archivos sin parar, así que casi
+// siempre tiene bloqueado el inodo del archivo o del directorio raíz
+// mientras espera al disco. Si llegan procesos de CPU que le ganan en la
+// cola baja, L no vuelve a correr, y un proceso interactivo de cola alta
+// (H) que necesita el mismo inodo queda esperando a L: inversión de
+// prioridad. Con herencia de prioridad, al esperar el sleeplock H sube a
+// L a la cola alta hasta que lo suelta.
+//
+// FASES:
+// 1. L escribe solo; H hace PROBES stat() del archivo de L
+// 2. Se sueltan NHOG procesos de CPU (durante HOGTICKS ticks) y H repite
+//    las mediciones
+//
+// MÉTRICAS:
+// - Latencia promedio y máxima de stat() en H (clock(), en us)
+// - Sin herencia de prioridad el máximo de la fase 2 se acerca a la
+//   duración de la carga (HOGTICKS ticks)
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ pitest [NHOG]
+// 2. Por defecto NHOG = 4; debe ser al menos el número de CPUs
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+#include "fcntl.h"
+#include "sysinfo.h"
+
+#define DEFAULT_HOGS 4
+#define HOGTICKS 300
+#define PROBES 20
+#define FILEKB 64
+
+char buf[1024];
+
+int
+now_us(void)
+{
+  struct clockval cv;
+
+  clock(&cv);
+  return cv.sec * 1000000 + cv.nsec / 1000;
+}
+
+// Gastar n ticks de CPU
+void
+burn(int n)
+{
+  int start;
+
+  start = uptime();
+  while(uptime() - start < n)
+    ;
+}
+
+// L: baja a la cola baja y escribe archivos nuevos para siempre. Cada
+// bloque nuevo se lee del disco con el inodo bloqueado.
+void
+writer(void)
+{
+  int fd, i;
+
+  burn(10);
+  memset(buf, 'p', sizeof(buf));
+  for(;;){
+    if((fd = open("pi.tmp", O_CREATE | O_RDWR)) < 0)
+      exit();
+    for(i = 0; i < FILEKB; i++)
+      write(fd, buf, sizeof(buf));
+    close(fd);
+    unlink("pi.tmp");
+  }
+}
+
+// Proceso de CPU: espera la señal y gira HOGTICKS ticks
+void
+hog(int gate)
+{
+  char c;
+
+  read(gate, &c, 1);
+  burn(HOGTICKS);
+  exit();
+}
+
+// H: un proceso nuevo (cola alta) que mide stat() del archivo de L
+void
+probe(char *label)
+{
+  int i, t, total, max;
+  struct stat st;
+
+  if(fork() != 0){
+    wait();
+    return;
+  }
+  total = 0;
+  max = 0;
+  for(i = 0; i < PROBES; i++){
+    t = now_us();
+    stat("pi.tmp", &st);
+    t = now_us() - t;
+    total += t;
+    if(t > max)
+      max = t;
+    sleep(1);
+  }
+  printf(1, "%s: stat promedio %d us, maximo %d us\n",
+         label, total / PROBES, max);
+  if(max > HOGTICKS * 10000 / 2)
+    printf(1, "[AVISO] H espero a L casi toda la carga: inversion de prioridad\n");
+  exit();
+}
+
+int
+main(int argc, char *argv[])
+{
+  int nhog, i, gate[2], writerpid;
+
+  nhog = DEFAULT_HOGS;
+  if(argc > 1)
+    nhog = atoi(argv[1]);
+  if(nhog < 1){
+    printf(1, "uso: pitest [NHOG]\n");
+    exit();
+  }
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE INVERSION DE PRIORIDAD - xv6\n");
+  printf(1, "========================================\n");
+  printf(1, "%d procesos de CPU durante %d ticks\n\n", nhog, HOGTICKS);
+
+  // Los procesos de CPU se crean primero para quedar antes que L en la
+  // lista de procesos: en la cola baja el planificador elige al primero.
+  if(pipe(gate) < 0){
+    printf(1, "[ERROR] pipe fallo\n");
+    exit();
+  }
+  for(i = 0; i < nhog; i++)
+    if(fork() == 0){
+      close(gate[1]);
+      hog(gate[0]);
+    }
+  close(gate[0]);
+  if((writerpid = fork()) == 0){
+    close(gate[1]);
+    writer();
+  }
+  sleep(20);   // L baja a la cola baja y empieza a escribir
+
+  // FASE 1: Sin carga
+  probe("Sin carga");
+
+  // FASE 2: Con carga de CPU
+  close(gate[1]);
+  probe("Con carga");
+
+  kill(writerpid);
+  while(wait() >= 0)
+    ;
+  unlink("pi.tmp");
+  printf(1, "========================================\n");
+  exit();
+}
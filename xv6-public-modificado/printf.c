@@ -2,14 +2,42 @@
 #include "stat.h"
 #include "user.h"
 
+// Output is collected in an outbuf and written with one write()
+// per line instead of one per character. printf flushes at every
+// newline and before returning, so nothing is left buffered across
+// calls (a later fork() would print it twice, and prompts such as
+// sh's "$ " must appear before the next read()).
+// With fd < 0 the buffer is a caller's string (snprintf).
+struct outbuf {
+  int fd;
+  char *buf;
+  int n;
+  int max;
+};
+
+static void
+flush(struct outbuf *o)
+{
+  if(o->fd >= 0 && o->n > 0)
+    write(o->fd, o->buf, o->n);
+  o->n = 0;
+}
+
 static void
-putc(int fd, char c)
+putc(struct outbuf *o, char c)
 {
-  write(fd, &c, 1);
+  if(o->fd < 0){
+    if(o->n < o->max - 1)   // leave room for the terminating 0
+      o->buf[o->n++] = c;
+    return;
+  }
+  o->buf[o->n++] = c;
+  if(c == '\n' || o->n == o->max)
+    flush(o);
 }
 
 static void
-printint(int fd, int xx, int base, int sgn)
+printint(struct outbuf *o, int xx, int base, int sgn)
 {
   static char digits[] = "0123456789ABCDEF";
   char buf[16];
@@ -32,33 +60,31 @@ printint(int fd, int xx, int base, int sgn)
     buf[i++] = '-';
 
   while(--i >= 0)
-    putc(fd, buf[i]);
+    putc(o, buf[i]);
 }
 
-// Print to the given fd. Only understands %d, %x, %p, %s.
-void
-printf(int fd, const char *fmt, ...)
+// Only understands %d, %x, %p, %s, %c.
+static void
+vprintf(struct outbuf *o, const char *fmt, uint *ap)
 {
   char *s;
   int c, i, state;
-  uint *ap;
 
   state = 0;
-  ap = (uint*)(void*)&fmt + 1;
   for(i = 0; fmt[i]; i++){
     c = fmt[i] & 0xff;
     if(state == 0){
       if(c == '%'){
         state = '%';
       } else {
-        putc(fd, c);
+        putc(o, c);
       }
     } else if(state == '%'){
       if(c == 'd'){
-        printint(fd, *ap, 10, 1);
+        printint(o, *ap, 10, 1);
         ap++;
       } else if(c == 'x' || c == 'p'){
-        printint(fd, *ap, 16, 0);
+        printint(o, *ap, 16, 0);
         ap++;
       } else if(c == 's'){
         s = (char*)*ap;
@@ -66,20 +92,53 @@ printf(int fd, const char *fmt, ...)
         if(s == 0)
           s = "(null)";
         while(*s != 0){
-          putc(fd, *s);
+          putc(o, *s);
           s++;
         }
       } else if(c == 'c'){
-        putc(fd, *ap);
+        putc(o, *ap);
         ap++;
       } else if(c == '%'){
-        putc(fd, c);
+        putc(o, c);
       } else {
         // Unknown % sequence.  Print it to draw attention.
-        putc(fd, '%');
-        putc(fd, c);
+        putc(o, '%');
+        putc(o, c);
       }
       state = 0;
     }
   }
 }
+
+// Print to the given fd.
+void
+printf(int fd, const char *fmt, ...)
+{
+  char buf[256];
+  struct outbuf o;
+
+  o.fd = fd;
+  o.buf = buf;
+  o.n = 0;
+  o.max = sizeof(buf);
+  vprintf(&o, fmt, (uint*)(void*)&fmt + 1);
+  flush(&o);
+}
+
+// Print into buf, writing at most n bytes including the final 0.
+// Returns the length of the string stored.
+int
+snprintf(char *buf, int n, const char *fmt, ...)
+{
+  struct outbuf o;
+
+  if(n <= 0)
+    return 0;
+  o.fd = -1;
+  o.buf = buf;
+  o.n = 0;
+  o.max = n;
+  vprintf(&o, fmt, (uint*)(void*)&fmt + 1);
+  buf[o.n] = 0;
+  return o.n;
+}
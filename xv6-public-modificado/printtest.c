@@ -0,0 +1,105 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE PRINTF EN XV6
+// ============================================================================
+// Este programa cuenta cuántas llamadas al sistema cuesta imprimir una
+// línea. El printf original hacía un write() por cada carácter; el printf
+// con buffer hace un write() por línea.
+//
+// FASES:
+// 1. Escribir N líneas carácter por carácter (como el printf original)
+// 2. Escribir N líneas con printf
+// 3. Formatear N líneas con snprintf (sin llamadas al sistema)
+//
+// Las líneas se escriben en el archivo "printtest.out" para no llenar la
+// consola; el archivo se borra al terminar.
+//
+// MÉTRICAS:
+// - Llamadas al sistema por línea (getsyscount)
+// - Ticks por fase
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ printtest [N]
+// 2. Por defecto N = 500 líneas
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+#include "fcntl.h"
+
+#define DEFAULT_LINES 500
+
+// Una línea típica de schedtest
+#define FMT "[MIX-%d] Finalizado en tick %d (duracion: %d ticks)\n"
+
+// printf original: un write() por carácter
+void
+putc_line(int fd, char *s)
+{
+  while(*s)
+    write(fd, s++, 1);
+}
+
+void
+report(char *phase, int n, int calls, int ticks)
+{
+  printf(1, "%s: %d lineas, %d syscalls (%d por linea), %d ticks\n",
+         phase, n, calls, calls / n, ticks);
+}
+
+int
+main(int argc, char *argv[])
+{
+  int n, i, fd, calls, start;
+  char line[80];
+
+  n = DEFAULT_LINES;
+  if(argc > 1)
+    n = atoi(argv[1]);
+  if(n <= 0){
+    printf(1, "printtest: N debe ser positivo\n");
+    exit();
+  }
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE PRINTF - xv6\n");
+  printf(1, "========================================\n");
+
+  fd = open("printtest.out", O_CREATE|O_RDWR);
+  if(fd < 0){
+    printf(1, "[ERROR] No se pudo crear printtest.out\n");
+    exit();
+  }
+
+  // FASE 1: Un write() por carácter
+  start = uptime();
+  calls = getsyscount();
+  for(i = 0; i < n; i++){
+    snprintf(line, sizeof(line), FMT, i % 3, i, i * 7);
+    putc_line(fd, line);
+  }
+  calls = getsyscount() - calls - 1;
+  report("Caracter por caracter", n, calls, uptime() - start);
+
+  // FASE 2: printf con buffer
+  start = uptime();
+  calls = getsyscount();
+  for(i = 0; i < n; i++)
+    printf(fd, FMT, i % 3, i, i * 7);
+  calls = getsyscount() - calls - 1;
+  report("printf", n, calls, uptime() - start);
+
+  // FASE 3: snprintf
+  start = uptime();
+  calls = getsyscount();
+  for(i = 0; i < n; i++)
+    snprintf(line, sizeof(line), FMT, i % 3, i, i * 7);
+  calls = getsyscount() - calls - 1;
+  report("snprintf", n, calls, uptime() - start);
+
+  close(fd);
+  unlink("printtest.out");
+  printf(1, "========================================\n");
+  exit();
+}
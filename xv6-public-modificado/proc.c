@@ -6,24 +6,42 @@
 #include "x86.h"
 #include "proc.h"
 #include "spinlock.h"
+#include "sysinfo.h"
 
+#define NPIDHASH 128
+
+// Proc structures are carved out of whole pages as needed and
+// never given back; an unused one waits on the free list.
+// Processes in use are on a list in creation order, which is
+// the order the scheduler and wakeup visit them.
 struct {
   struct spinlock lock;
-  struct proc proc[NPROC];
+  struct proc *head;              // procs in use
+  struct proc *tail;
+  struct proc *free;              // UNUSED procs
+  struct proc *pidhash[NPIDHASH]; // procs in use, by pid
 } ptable;
 
 static struct proc *initproc;
 
+// Serializes growproc() among threads sharing a pgdir. Not
+// ptable.lock: allocuvm() may queue work, which calls wakeup().
+static struct spinlock growlock;
+
 int nextpid = 1;
 extern void forkret(void);
 extern void trapret(void);
+extern pde_t *kpgdir;
 
 static void wakeup1(void *chan);
+static void rtdrop(struct proc *p);
+static void setnice(struct proc *p, int nice);
 
 void
 pinit(void)
 {
   initlock(&ptable.lock, "ptable");
+  initlock(&growlock, "growproc");
 }
 
 // Must be called with interrupts disabled
@@ -65,29 +83,148 @@ myproc(void) {
   return p;
 }
 
+// Look up a process by pid.
+// The ptable lock must be held.
+static struct proc*
+findproc(int pid)
+{
+  struct proc *p;
+
+  if(pid <= 0)
+    return 0;
+  for(p = ptable.pidhash[pid % NPIDHASH]; p; p = p->hnext)
+    if(p->pid == pid)
+      return p;
+  return 0;
+}
+
+// Make p a child of parent.
+// The ptable lock must be held.
+static void
+addchild(struct proc *parent, struct proc *p)
+{
+  p->parent = parent;
+  p->sibprev = 0;
+  p->sibnext = parent->child;
+  if(p->sibnext)
+    p->sibnext->sibprev = p;
+  parent->child = p;
+}
+
+// Take p off its parent's list of children.
+// The ptable lock must be held.
+static void
+delchild(struct proc *p)
+{
+  if(p->sibprev)
+    p->sibprev->sibnext = p->sibnext;
+  else
+    p->parent->child = p->sibnext;
+  if(p->sibnext)
+    p->sibnext->sibprev = p->sibprev;
+  p->parent = 0;
+}
+
+// Wake whoever in process p sleeps in wait() or join().
+// They sleep on the leader p; without threads that can
+// only be p itself, so skip the scan of wakeup1().
+// The ptable lock must be held.
+static void
+wakewaiter(struct proc *p)
+{
+  if(p->nthread > 0)
+    wakeup1(p);
+  else if(p->state == SLEEPING && p->chan == p)
+    p->state = RUNNABLE;
+}
+
+// Take p off the in-use list and the pid hash and put it
+// on the free list. Its memory must already be freed.
+// The ptable lock must be held.
+static void
+freeproc(struct proc *p)
+{
+  struct proc **pp;
+
+  if(p->parent)
+    delchild(p);
+
+  if(p->prev)
+    p->prev->next = p->next;
+  else
+    ptable.head = p->next;
+  if(p->next)
+    p->next->prev = p->prev;
+  else
+    ptable.tail = p->prev;
+
+  for(pp = &ptable.pidhash[p->pid % NPIDHASH]; *pp != p; pp = &(*pp)->hnext)
+    ;
+  *pp = p->hnext;
+
+  p->pid = 0;
+  p->name[0] = 0;
+  p->killed = 0;
+  p->state = UNUSED;
+  p->prev = 0;
+  p->next = ptable.free;
+  ptable.free = p;
+}
+
+// Free a thread that has exited. Its address space
+// belongs to its leader.
+// The ptable lock must be held.
+static void
+reapthread(struct proc *t)
+{
+  kstackfree(t->kstack);
+  t->kstack = 0;
+  t->pgdir = 0;
+  t->leader->nthread--;
+  freeproc(t);
+}
+
 //PAGEBREAK: 32
-// Look in the process table for an UNUSED proc.
-// If found, change state to EMBRYO and initialize
-// state required to run in the kernel.
-// Otherwise return 0.
+// Take an UNUSED proc off the free list, allocating a page
+// of them if the list is empty. Change its state to EMBRYO
+// and initialize state required to run in the kernel.
+// Return 0 if out of memory.
 static struct proc*
 allocproc(void)
 {
-  struct proc *p;
+  struct proc *p, *pg;
   char *sp;
+  int i;
 
   acquire(&ptable.lock);
+  while(ptable.free == 0){
+    release(&ptable.lock);
+    if((pg = (struct proc*)kalloc()) == 0)
+      return 0;
+    memset(pg, 0, PGSIZE);
+    acquire(&ptable.lock);
+    for(i = 0; i < PGSIZE / sizeof(struct proc); i++){
+      pg[i].next = ptable.free;
+      ptable.free = &pg[i];
+    }
+  }
+  p = ptable.free;
+  ptable.free = p->next;
 
-  for(p = ptable.proc; p < &ptable.proc[NPROC]; p++)
-    if(p->state == UNUSED)
-      goto found;
-
-  release(&ptable.lock);
-  return 0;
-
-found:
   p->state = EMBRYO;
   p->pid = nextpid++;
+  p->leader = p;
+  p->nthread = 0;
+  p->ustack = 0;
+  p->hnext = ptable.pidhash[p->pid % NPIDHASH];
+  ptable.pidhash[p->pid % NPIDHASH] = p;
+  p->next = 0;
+  p->prev = ptable.tail;
+  if(ptable.tail)
+    ptable.tail->next = p;
+  else
+    ptable.head = p;
+  ptable.tail = p;
 
   // ========================================================================
   // INICIALIZACIÓN MLFQ: Configurar prioridad y ticks para nuevo proceso
@@ -97,14 +234,31 @@ found:
   // ========================================================================
   p->priority = 0;      // Cola alta: procesos nuevos/interactivos
   p->ticks_used = 0;    // Contador de ticks inicializado en cero
+  p->nice = 0;
+  p->boost = 0;
+  p->rtperiod = 0;
+  p->nsyscall = 0;
+  p->nswitch = 0;
 
   release(&ptable.lock);
 
-  // Allocate kernel stack.
-  if((p->kstack = kalloc()) == 0){
-    p->state = UNUSED;
+  // Allocate kernel stack and the read-only info page.
+  if((p->kstack = kstackalloc()) == 0){
+    acquire(&ptable.lock);
+    freeproc(p);
+    release(&ptable.lock);
     return 0;
   }
+  if((p->infopage = kalloc()) == 0){
+    kstackfree(p->kstack);
+    p->kstack = 0;
+    acquire(&ptable.lock);
+    freeproc(p);
+    release(&ptable.lock);
+    return 0;
+  }
+  memset(p->infopage, 0, PGSIZE);
+  ((struct procinfo*)p->infopage)->pid = p->pid;
   sp = p->kstack + KSTACKSIZE;
 
   // Leave room for trap frame.
@@ -135,7 +289,7 @@ userinit(void)
   p = allocproc();
   
   initproc = p;
-  if((p->pgdir = setupkvm()) == 0)
+  if((p->pgdir = setupkvm()) == 0 || mapsysinfo(p->pgdir, p->infopage) < 0)
     panic("userinit: out of memory?");
   inituvm(p->pgdir, _binary_initcode_start, (int)_binary_initcode_size);
   p->sz = PGSIZE;
@@ -162,25 +316,88 @@ userinit(void)
   release(&ptable.lock);
 }
 
+static void
+kthreadmain(void (*fn)(void*), void *arg)
+{
+  fn(arg);
+  panic("kthread returned");
+}
+
+// Start a kernel thread running fn(arg). It has a kernel
+// stack but no user memory, runs on the kernel page table,
+// and is scheduled like any process. fn must not return.
+struct proc*
+kthread(char *name, void (*fn)(void*), void *arg)
+{
+  struct proc *p;
+  uint *sp;
+
+  if((p = allocproc()) == 0)
+    panic("kthread");
+  kfree(p->infopage);
+  p->infopage = 0;
+  p->pgdir = kpgdir;
+
+  // allocproc() left trapret as forkret's return address,
+  // just below the trap frame. Return to kthreadmain(fn, arg)
+  // instead, with the unused trap frame as its stack.
+  sp = (uint*)p->tf;
+  sp[-1] = (uint)kthreadmain;
+  sp[0] = 0;              // kthreadmain's return address
+  sp[1] = (uint)fn;
+  sp[2] = (uint)arg;
+
+  safestrcpy(p->name, name, sizeof(p->name));
+
+  acquire(&ptable.lock);
+  p->state = RUNNABLE;
+  release(&ptable.lock);
+  return p;
+}
+
 // Grow current process's memory by n bytes.
-// Return 0 on success, -1 on failure.
+// Return the old size on success, -1 on failure.
+// Threads share the page table, so with threads growlock lets
+// one resize it at a time and every thread gets the new size.
+// A process with threads can only grow: other CPUs running its
+// threads may still have TLB entries for the pages deallocuvm()
+// would free, and there is no TLB shootdown.
 int
 growproc(int n)
 {
-  uint sz;
+  uint sz, oldsz;
   struct proc *curproc = myproc();
+  struct proc *leader = curproc->leader;
+  struct proc *p;
+  int threads;
 
-  sz = curproc->sz;
-  if(n > 0){
-    if((sz = allocuvm(curproc->pgdir, sz, sz + n)) == 0)
-      return -1;
-  } else if(n < 0){
-    if((sz = deallocuvm(curproc->pgdir, sz, sz + n)) == 0)
-      return -1;
+  threads = leader->nthread > 0;
+  if(threads && n < 0)
+    return -1;
+  if(threads)
+    acquire(&growlock);
+  oldsz = sz = curproc->sz;
+  if(n > 0)
+    sz = allocuvm(curproc->pgdir, sz, sz + n);
+  else if(n < 0)
+    sz = deallocuvm(curproc->pgdir, sz, sz + n);
+  if(sz == 0){
+    if(threads)
+      release(&growlock);
+    return -1;
   }
   curproc->sz = sz;
+  if(threads){
+    acquire(&ptable.lock);
+    leader->sz = sz;
+    for(p = leader->child; p; p = p->sibnext)
+      if(p->leader == leader)
+        p->sz = sz;
+    release(&ptable.lock);
+    release(&growlock);
+  }
   switchuvm(curproc);
-  return 0;
+  return oldsz;
 }
 
 // Create a new process copying p as the parent.
@@ -199,14 +416,20 @@ fork(void)
   }
 
   // Copy process state from proc.
-  if((np->pgdir = copyuvm(curproc->pgdir, curproc->sz)) == 0){
-    kfree(np->kstack);
+  if((np->pgdir = copyuvm(curproc->pgdir, curproc->sz)) == 0 ||
+     mapsysinfo(np->pgdir, np->infopage) < 0){
+    if(np->pgdir)
+      freevm(np->pgdir);
+    kstackfree(np->kstack);
     np->kstack = 0;
-    np->state = UNUSED;
+    kfree(np->infopage);
+    np->infopage = 0;
+    acquire(&ptable.lock);
+    freeproc(np);
+    release(&ptable.lock);
     return -1;
   }
   np->sz = curproc->sz;
-  np->parent = curproc;
   *np->tf = *curproc->tf;
 
   // Clear %eax so that fork returns 0 in the child.
@@ -223,6 +446,9 @@ fork(void)
 
   acquire(&ptable.lock);
 
+  // A child forked by a thread belongs to the whole process.
+  addchild(curproc->leader, np);
+  setnice(np, curproc->nice);
   np->state = RUNNABLE;
 
   release(&ptable.lock);
@@ -230,9 +456,137 @@ fork(void)
   return pid;
 }
 
+// Create a thread: a process that shares the caller's page
+// table and runs fn(arg) on the PGSIZE-byte user stack at
+// stack. The thread's parent is the caller's leader; it is
+// collected with join(), not wait(). Return its pid.
+int
+clone(void (*fn)(void*), void *arg, void *stack)
+{
+  int i, pid;
+  uint sp, ustack[2];
+  struct proc *np;
+  struct proc *curproc = myproc();
+
+  if((np = allocproc()) == 0)
+    return -1;
+  kfree(np->infopage);          // upid() reads the leader's page
+  np->infopage = 0;
+
+  // Enter fn with arg and an invalid return address: a thread
+  // must end with exit().
+  sp = (uint)stack + PGSIZE;
+  ustack[0] = 0xffffffff;
+  ustack[1] = (uint)arg;
+  sp -= sizeof(ustack);
+  if(copyout(curproc->pgdir, sp, ustack, sizeof(ustack)) < 0){
+    kstackfree(np->kstack);
+    np->kstack = 0;
+    acquire(&ptable.lock);
+    freeproc(np);
+    release(&ptable.lock);
+    return -1;
+  }
+
+  np->pgdir = curproc->pgdir;
+  np->sz = curproc->sz;
+  np->leader = curproc->leader;
+  np->ustack = stack;
+  *np->tf = *curproc->tf;
+  np->tf->eip = (uint)fn;
+  np->tf->esp = sp;
+
+  for(i = 0; i < NOFILE; i++)
+    if(curproc->ofile[i])
+      np->ofile[i] = filedup(curproc->ofile[i]);
+  np->cwd = idup(curproc->cwd);
+
+  safestrcpy(np->name, curproc->name, sizeof(curproc->name));
+
+  pid = np->pid;
+
+  acquire(&ptable.lock);
+
+  addchild(np->leader, np);
+  np->leader->nthread++;
+  setnice(np, curproc->nice);
+  np->state = RUNNABLE;
+
+  release(&ptable.lock);
+
+  return pid;
+}
+
+// Wait for another thread of the caller's process to exit.
+// Store its user stack in *stack and return its pid.
+// Return -1 if the process has no other threads.
+int
+join(void **stack)
+{
+  struct proc *p;
+  int havethreads, pid;
+  struct proc *curproc = myproc();
+  struct proc *leader = curproc->leader;
+
+  acquire(&ptable.lock);
+  for(;;){
+    havethreads = 0;
+    for(p = leader->child; p; p = p->sibnext){
+      if(p->leader != leader || p == curproc)
+        continue;
+      havethreads = 1;
+      if(p->state == ZOMBIE){
+        pid = p->pid;
+        *stack = p->ustack;
+        reapthread(p);
+        release(&ptable.lock);
+        return pid;
+      }
+    }
+
+    if(!havethreads || curproc->killed){
+      release(&ptable.lock);
+      return -1;
+    }
+
+    // Exiting threads wake the leader's sleepers.
+    sleep(leader, &ptable.lock);
+  }
+}
+
+// Kill the threads of process p, which is exiting, and
+// collect them. Their user code may be running on other
+// CPUs; it stops at the next trap (see trap in trap.c).
+static void
+killthreads(struct proc *p)
+{
+  struct proc *t, *next;
+
+  acquire(&ptable.lock);
+  while(p->nthread > 0){
+    for(t = p->child; t; t = next){
+      next = t->sibnext;
+      if(t->leader != p)
+        continue;
+      if(t->state == ZOMBIE){
+        reapthread(t);
+        continue;
+      }
+      t->killed = 1;
+      if(t->state == SLEEPING)
+        t->state = RUNNABLE;
+    }
+    if(p->nthread > 0)
+      sleep(p, &ptable.lock);
+  }
+  release(&ptable.lock);
+}
+
 // Exit the current process.  Does not return.
 // An exited process remains in the zombie state
 // until its parent calls wait() to find out it exited.
+// A thread ends only itself; it stays a zombie until
+// join(). A process with threads ends them first.
 void
 exit(void)
 {
@@ -243,6 +597,9 @@ exit(void)
   if(curproc == initproc)
     panic("init exiting");
 
+  if(curproc->nthread > 0)
+    killthreads(curproc);
+
   // Close all open files.
   for(fd = 0; fd < NOFILE; fd++){
     if(curproc->ofile[fd]){
@@ -258,18 +615,19 @@ exit(void)
 
   acquire(&ptable.lock);
 
-  // Parent might be sleeping in wait().
-  wakeup1(curproc->parent);
+  // Parent might be sleeping in wait() or join().
+  wakewaiter(curproc->parent);
 
   // Pass abandoned children to init.
-  for(p = ptable.proc; p < &ptable.proc[NPROC]; p++){
-    if(p->parent == curproc){
-      p->parent = initproc;
-      if(p->state == ZOMBIE)
-        wakeup1(initproc);
-    }
+  while((p = curproc->child) != 0){
+    delchild(p);
+    addchild(initproc, p);
+    if(p->state == ZOMBIE)
+      wakewaiter(initproc);
   }
 
+  rtdrop(curproc);
+
   // Jump into the scheduler, never to return.
   curproc->state = ZOMBIE;
   sched();
@@ -278,32 +636,32 @@ exit(void)
 
 // Wait for a child process to exit and return its pid.
 // Return -1 if this process has no children.
+// Threads are not children here; see join().
 int
 wait(void)
 {
   struct proc *p;
   int havekids, pid;
   struct proc *curproc = myproc();
+  struct proc *leader = curproc->leader;
   
   acquire(&ptable.lock);
   for(;;){
-    // Scan through table looking for exited children.
+    // Scan through children looking for exited ones.
     havekids = 0;
-    for(p = ptable.proc; p < &ptable.proc[NPROC]; p++){
-      if(p->parent != curproc)
+    for(p = leader->child; p; p = p->sibnext){
+      if(p->leader != p)
         continue;
       havekids = 1;
       if(p->state == ZOMBIE){
         // Found one.
         pid = p->pid;
-        kfree(p->kstack);
+        kstackfree(p->kstack);
         p->kstack = 0;
         freevm(p->pgdir);
-        p->pid = 0;
-        p->parent = 0;
-        p->name[0] = 0;
-        p->killed = 0;
-        p->state = UNUSED;
+        kfree(p->infopage);
+        p->infopage = 0;
+        freeproc(p);
         release(&ptable.lock);
         return pid;
       }
@@ -315,11 +673,165 @@ wait(void)
       return -1;
     }
 
-    // Wait for children to exit.  (See wakeup1 call in proc_exit.)
-    sleep(curproc, &ptable.lock);  //DOC: wait-sleep
+    // Wait for children to exit.  (See wakewaiter call in exit.)
+    sleep(leader, &ptable.lock);  //DOC: wait-sleep
   }
 }
 
+// ============================================================================
+// CLASE DE TIEMPO REAL (EDF)
+// ============================================================================
+// Un proceso con reserva (rtset) recibe rtruntime ticks de CPU en cada
+// período de rtperiod ticks, y el trabajo de cada período debe terminar
+// a más tardar rtdeadline ticks después de empezar. Estos procesos van
+// antes que las dos colas MLFQ y entre ellos corre el de plazo más
+// cercano (Earliest Deadline First). El que gasta su presupuesto espera
+// al período siguiente aunque haya CPU libre, así nunca quita a los
+// demás más de lo reservado. El control de admisión rechaza reservas
+// que en total pasen de RTMAXUTIL milésimas de CPU.
+// ============================================================================
+
+#define RTMAXPERIOD 100000  // Período máximo en ticks (evita desbordes)
+
+static int rtutil;   // Milésimas de CPU reservadas (con ptable.lock)
+static int nrt;      // Procesos de tiempo real (con ptable.lock)
+
+// Milésimas de CPU que pide una reserva, redondeando hacia arriba
+// para que una reserva chica nunca cueste 0.
+static int
+rtcost(int runtime, int period)
+{
+  return (runtime * 1000 + period - 1) / period;
+}
+
+// Llevar p al período actual. Cuenta como incumplido cada período que
+// terminó sin que p llamara a rtwait().
+// The ptable lock must be held.
+static void
+rtrefresh(struct proc *p)
+{
+  uint n;
+
+  if(ticks - p->rtstart < p->rtperiod)
+    return;
+  n = (ticks - p->rtstart) / p->rtperiod;
+  p->rtmiss += p->rtdone ? n - 1 : n;
+  p->rtstart += n * p->rtperiod;
+  p->rtused = 0;
+  p->rtdone = 0;
+}
+
+// Devolver la reserva de p al salir de la clase de tiempo real.
+// The ptable lock must be held.
+static void
+rtdrop(struct proc *p)
+{
+  if(p->rtperiod == 0)
+    return;
+  rtutil -= rtcost(p->rtruntime, p->rtperiod);
+  nrt--;
+  p->rtperiod = 0;
+}
+
+// El proceso de tiempo real listo, con presupuesto, de plazo más
+// cercano; 0 si no hay.
+// The ptable lock must be held.
+static struct proc*
+edfpick(void)
+{
+  struct proc *p, *best;
+
+  best = 0;
+  for(p = ptable.head; p; p = p->next){
+    if(p->state != RUNNABLE || p->rtperiod == 0)
+      continue;
+    rtrefresh(p);
+    if(p->rtused >= p->rtruntime)
+      continue;
+    if(best == 0 || (int)(p->rtstart + p->rtdeadline -
+                          (best->rtstart + best->rtdeadline)) < 0)
+      best = p;
+  }
+  return best;
+}
+
+// Pedir runtime ticks de CPU cada period ticks con plazo deadline.
+// runtime == 0 vuelve a MLFQ. Devuelve -1 si los valores no tienen
+// sentido o si la reserva no entra (control de admisión).
+int
+rtset(int period, int runtime, int deadline)
+{
+  struct proc *p = myproc();
+  int util, old;
+
+  if(runtime != 0 && (runtime < 0 || runtime > deadline ||
+                      deadline > period || period > RTMAXPERIOD))
+    return -1;
+  util = runtime ? rtcost(runtime, period) : 0;
+
+  acquire(&ptable.lock);
+  old = p->rtperiod ? rtcost(p->rtruntime, p->rtperiod) : 0;
+  if(rtutil - old + util > RTMAXUTIL){
+    release(&ptable.lock);
+    return -1;
+  }
+  rtdrop(p);
+  if(runtime){
+    rtutil += util;
+    nrt++;
+    p->rtperiod = period;
+    p->rtruntime = runtime;
+    p->rtdeadline = deadline;
+    p->rtstart = ticks;
+    p->rtused = 0;
+    p->rtdone = 0;
+    p->rtmiss = 0;
+  }
+  release(&ptable.lock);
+  return 0;
+}
+
+// Terminar el trabajo de este período y dormir hasta el siguiente.
+// Devuelve los plazos incumplidos hasta ahora, o -1.
+int
+rtwait(void)
+{
+  struct proc *p = myproc();
+  uint next;
+  int miss;
+
+  acquire(&ptable.lock);
+  if(p->rtperiod == 0){
+    release(&ptable.lock);
+    return -1;
+  }
+  if(ticks - p->rtstart < p->rtperiod){
+    if(ticks - p->rtstart > p->rtdeadline)
+      p->rtmiss++;
+    p->rtdone = 1;
+    next = p->rtstart + p->rtperiod;
+  } else {
+    // El trabajo terminó después de que venciera su período:
+    // rtrefresh() ya lo cuenta como incumplido, y el período
+    // actual todavía no se hizo, así que no hay que dormir.
+    rtrefresh(p);
+    next = ticks;
+  }
+  miss = p->rtmiss;
+  release(&ptable.lock);
+
+  acquire(&tickslock);
+  while((int)(ticks - next) < 0){
+    if(p->killed){
+      release(&tickslock);
+      return -1;
+    }
+    sleep(&ticks, &tickslock);
+  }
+  release(&tickslock);
+  return miss;
+}
+
 //PAGEBREAK: 42
 // ============================================================================
 // SCHEDULER MLFQ (Multi-Level Feedback Queue) CON 2 COLAS
@@ -353,10 +865,16 @@ wait(void)
 // - Procesos CPU-bound no bloquean a procesos pequeños
 // - Implementación simple y predecible
 //
+// Por encima de las dos colas están los procesos de tiempo real (EDF,
+// ver rtset): si alguno está listo y le queda presupuesto, va primero.
+// Los de tiempo real nunca se eligen desde las colas MLFQ.
+//
 // ALGORITMO:
 // ----------
 // 1. Habilitar interrupciones (permite timer y otras IRQs)
 // 2. Adquirir lock de tabla de procesos
+// 2b. Si hay un proceso de tiempo real listo, ejecutar el de plazo
+//     más cercano y volver al paso 1
 // 3. Buscar proceso RUNNABLE en Cola 0 (priority == 0)
 // 4. Si se encuentra, ejecutarlo y volver al paso 1
 // 5. Si Cola 0 vacía, buscar en Cola 1 (priority == 1)
@@ -378,14 +896,28 @@ scheduler(void)
     // Adquirir el lock de la tabla de procesos para acceso seguro
     acquire(&ptable.lock);
     
+    // ========================================================================
+    // FASE 0: TIEMPO REAL (EDF), antes que cualquier cola MLFQ
+    // ========================================================================
+    if(nrt > 0 && (p = edfpick()) != 0){
+      c->proc = p;
+      switchuvm(p);
+      p->state = RUNNING;
+      swtch(&(c->scheduler), p->context);
+      switchkvm();
+      c->proc = 0;
+      release(&ptable.lock);
+      continue;
+    }
+
     // ========================================================================
     // FASE 1: Buscar y ejecutar procesos de COLA ALTA (priority == 0)
     // ========================================================================
     // Iterar sobre toda la tabla de procesos buscando candidatos en cola alta
     // Esta cola tiene prioridad absoluta sobre la cola baja
-    for(p = ptable.proc; p < &ptable.proc[NPROC]; p++){
+    for(p = ptable.head; p; p = p->next){
       // Filtrar: solo procesos RUNNABLE en cola de alta prioridad
-      if(p->state != RUNNABLE || p->priority != 0)
+      if(p->state != RUNNABLE || p->priority != 0 || p->rtperiod)
         continue;
       
       // Proceso encontrado en cola alta - ejecutarlo inmediatamente
@@ -420,9 +952,9 @@ scheduler(void)
     // o si ya ejecutamos uno y c->proc fue reseteado a 0
     if(c->proc == 0){
       // Iterar sobre toda la tabla de procesos buscando candidatos en cola baja
-      for(p = ptable.proc; p < &ptable.proc[NPROC]; p++){
+      for(p = ptable.head; p; p = p->next){
         // Filtrar: solo procesos RUNNABLE en cola de baja prioridad
-        if(p->state != RUNNABLE || p->priority != 1)
+        if(p->state != RUNNABLE || p->priority != 1 || p->rtperiod)
           continue;
         
         // Proceso encontrado en cola baja - ejecutarlo
@@ -477,6 +1009,7 @@ sched(void)
   if(readeflags()&FL_IF)
     panic("sched interruptible");
   intena = mycpu()->intena;
+  p->nswitch++;
   swtch(&p->context, mycpu()->scheduler);
   mycpu()->intena = intena;
 }
@@ -559,11 +1092,22 @@ wakeup1(void *chan)
 {
   struct proc *p;
 
-  for(p = ptable.proc; p < &ptable.proc[NPROC]; p++)
+  for(p = ptable.head; p; p = p->next)
     if(p->state == SLEEPING && p->chan == chan)
       p->state = RUNNABLE;
 }
 
+// Wake p if it is sleeping on chan, without scanning
+// the process list.
+void
+wakeupproc(struct proc *p, void *chan)
+{
+  acquire(&ptable.lock);
+  if(p->state == SLEEPING && p->chan == chan)
+    p->state = RUNNABLE;
+  release(&ptable.lock);
+}
+
 // Wake up all processes sleeping on chan.
 void
 wakeup(void *chan)
@@ -582,18 +1126,152 @@ kill(int pid)
   struct proc *p;
 
   acquire(&ptable.lock);
-  for(p = ptable.proc; p < &ptable.proc[NPROC]; p++){
-    if(p->pid == pid){
-      p->killed = 1;
-      // Wake process from sleep if necessary.
-      if(p->state == SLEEPING)
-        p->state = RUNNABLE;
-      release(&ptable.lock);
-      return 0;
-    }
+  if((p = findproc(pid)) == 0){
+    release(&ptable.lock);
+    return -1;
   }
+  p->killed = 1;
+  // Wake process from sleep if necessary.
+  if(p->state == SLEEPING)
+    p->state = RUNNABLE;
+  release(&ptable.lock);
+  return 0;
+}
+
+// ============================================================================
+// VALORES NICE
+// ============================================================================
+// El nice de un proceso (NICEMIN..NICEMAX, 0 por omisión, heredado por
+// fork y clone) sesga el MLFQ sin cambiar sus reglas:
+// - Cola inicial: con nice > 0 el proceso empieza en la cola baja, como
+//   un trabajo por lotes; si no, en la alta.
+// - Quantum de la cola alta: 5 - nice/4 ticks (10 con nice -20).
+// En la cola baja el nice no cuenta: elegir siempre al de menor nice
+// dejaría sin CPU para siempre a los de nice mayor.
+// ============================================================================
+
+// Fijar el nice de p y llevarlo a la cola que le corresponde.
+// Si p tiene la cola alta prestada (boost), cambia la cola a la
+// que vuelve al devolverla.
+// The ptable lock must be held.
+static void
+setnice(struct proc *p, int nice)
+{
+  int *q;
+
+  if(nice < NICEMIN)
+    nice = NICEMIN;
+  if(nice > NICEMAX)
+    nice = NICEMAX;
+  q = p->boost ? &p->boostprio : &p->priority;
+  if(nice > 0 && *q == 0){
+    *q = 1;
+    p->ticks_used = 0;
+  } else if(nice <= 0 && p->nice > 0){
+    *q = 0;                   // Deja de ser un trabajo por lotes
+    p->ticks_used = 0;
+  }
+  p->nice = nice;
+}
+
+// Nice del proceso pid (0: el que llama), o -1 si no existe.
+// Como en Unix, -1 también es un nice válido.
+int
+getpriority(int pid)
+{
+  struct proc *p;
+  int nice;
+
+  if(pid == 0)
+    return myproc()->nice;
+  acquire(&ptable.lock);
+  nice = (p = findproc(pid)) ? p->nice : -1;
+  release(&ptable.lock);
+  return nice;
+}
+
+// Cambiar el nice del proceso pid (0: el que llama). Los valores
+// fuera de NICEMIN..NICEMAX se recortan.
+int
+setpriority(int pid, int nice)
+{
+  struct proc *p;
+
+  if(pid == 0)
+    pid = myproc()->pid;
+  acquire(&ptable.lock);
+  if((p = findproc(pid)) == 0){
+    release(&ptable.lock);
+    return -1;
+  }
+  setnice(p, nice);
+  release(&ptable.lock);
+  return 0;
+}
+
+// ============================================================================
+// HERENCIA DE PRIORIDAD EN SLEEPLOCKS
+// ============================================================================
+// Si un proceso de cola alta espera un sleeplock cuyo dueño está en cola
+// baja, el dueño puede no volver a correr nunca: la cola alta va siempre
+// primero y en la cola baja el planificador elige al primero de la lista.
+// Mientras tenga el lock, el dueño sube a la cola alta (acquiresleep)
+// y no se lo degrada aunque agote su quantum; al soltar el último lock
+// que se lo prestó vuelve a la cola que tenía antes.
+// ============================================================================
+
+// Prestar la prioridad de myproc() al proceso pid, dueño del
+// sleeplock que myproc() va a esperar. Devuelve 1 si el lock
+// cuenta en p->boost y releasesleep() debe llamar a unboostproc().
+int
+boostproc(int pid)
+{
+  struct proc *p;
+  int r;
+
+  r = 0;
+  acquire(&ptable.lock);
+  p = findproc(pid);
+  if(p && myproc()->priority == 0){
+    if(p->boost++ == 0)
+      p->boostprio = p->priority;
+    p->priority = 0;
+    r = 1;
+  }
+  release(&ptable.lock);
+  return r;
+}
+
+// myproc() soltó un sleeplock por el que le prestaron prioridad.
+void
+unboostproc(void)
+{
+  struct proc *p = myproc();
+
+  acquire(&ptable.lock);
+  if(--p->boost == 0){
+    p->priority = p->boostprio;
+    p->ticks_used = 0;
+  }
+  release(&ptable.lock);
+}
+
+// Return the most kernel stack, in bytes, that process pid
+// (or the caller, if pid is 0) has used so far, or -1.
+int
+kstackuse(int pid)
+{
+  struct proc *p;
+  int n;
+
+  if(pid == 0)
+    pid = myproc()->pid;
+  n = -1;
+  acquire(&ptable.lock);
+  if((p = findproc(pid)) != 0 && p->kstack)
+    n = kstackused(p->kstack);
   release(&ptable.lock);
-  return -1;
+  return n;
 }
 
 //PAGEBREAK: 36
@@ -616,14 +1294,15 @@ procdump(void)
   char *state;
   uint pc[10];
 
-  for(p = ptable.proc; p < &ptable.proc[NPROC]; p++){
+  for(p = ptable.head; p; p = p->next){
     if(p->state == UNUSED)
       continue;
     if(p->state >= 0 && p->state < NELEM(states) && states[p->state])
       state = states[p->state];
     else
       state = "???";
-    cprintf("%d %s %s", p->pid, state, p->name);
+    cprintf("%d %s %s kstack %d", p->pid, state, p->name,
+            p->kstack ? kstackused(p->kstack) : 0);
     if(p->state == SLEEPING){
       getcallerpcs((uint*)p->context->ebp+2, pc);
       for(i=0; i<10 && pc[i] != 0; i++)
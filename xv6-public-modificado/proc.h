@@ -51,6 +51,30 @@ struct proc {
   char name[16];               // Process name (debugging)
   int priority;      // 0 = alta prioridad, 1 = baja prioridad
   int ticks_used;    // Ticks usados en la cola actual
+  int nice;          // NICEMIN..NICEMAX: cola inicial y quantum (setpriority)
+  uint nsyscall;     // Llamadas al sistema hechas (getsyscount)
+  uint nswitch;      // Cambios de contexto (getcswitch)
+  char *infopage;    // Página de solo lectura con el pid (sysinfo.h)
+  struct proc *next; // Lista de procesos en uso, o lista libre (ptable)
+  struct proc *prev;
+  struct proc *hnext;  // Siguiente en la cadena del hash de pids
+  struct proc *child;  // Primer hijo: lista de hijos para wait() y exit()
+  struct proc *sibnext;  // Hermanos en la lista de hijos del padre
+  struct proc *sibprev;
+  struct proc *leader; // Dueño del espacio de direcciones (él mismo si no es un hilo)
+  int nthread;         // Hilos del proceso sin recoger (solo en el líder)
+  void *ustack;        // Pila de usuario de un hilo (clone/join)
+  uint *futexkey;      // Palabra por la que espera en futex(), o 0
+  struct proc *futexnext;  // Siguiente en la cola del futex
+  int boost;           // Sleeplocks tomados que le prestaron la cola alta
+  int boostprio;       // Cola a la que vuelve cuando boost llega a 0
+  int rtperiod;        // Tiempo real (EDF): período en ticks, 0 si usa MLFQ
+  int rtruntime;       // Ticks de CPU reservados en cada período
+  int rtdeadline;      // Plazo, en ticks desde el inicio del período
+  uint rtstart;        // Tick en que empezó el período actual
+  int rtused;          // Ticks de CPU usados en el período actual
+  int rtdone;          // Ya terminó el trabajo del período (rtwait)
+  int rtmiss;          // Plazos incumplidos
 };
 
 // Process memory is laid out contiguously, low addresses first:
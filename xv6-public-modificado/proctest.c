@@ -0,0 +1,117 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE LA TABLA DE PROCESOS EN XV6
+// ============================================================================
+// Este programa crea miles de procesos vivos a la vez. Con la tabla fija
+// de NPROC = 64 entradas fork fallaba al llegar a 64, y allocproc, kill
+// y wait recorrían todo el arreglo. Ahora los proc se toman de una lista
+// libre (que crece de a una página), kill busca el pid en una tabla hash
+// y el kernel comparte sus tablas de páginas entre procesos, así que el
+// límite es solo la memoria.
+//
+// FASES:
+// 1. Crear N hijos que se bloquean leyendo de un pipe
+// 2. Matar a cada hijo con kill(pid)
+// 3. Recoger a cada hijo con wait()
+//
+// MÉTRICAS:
+// - Procesos creados (fork puede fallar antes de N si falta memoria)
+// - Microsegundos totales y por operación en cada fase (clock())
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ proctest [N]
+// 2. Por defecto N = 2000
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+#include "sysinfo.h"
+
+#define DEFAULT_PROCS 2000
+#define MAXPROCS 10000
+
+int *pids;   // Del tamaño justo: cada hijo copia toda la memoria del padre
+
+int
+now_us(void)
+{
+  struct clockval cv;
+
+  clock(&cv);
+  return cv.sec * 1000000 + cv.nsec / 1000;
+}
+
+void
+report(char *phase, int n, int us)
+{
+  printf(1, "%s: %d en %d us (%d us c/u)\n", phase, n, us,
+         n > 0 ? us / n : 0);
+}
+
+int
+main(int argc, char *argv[])
+{
+  int n, i, pid, fds[2], killed, reaped, start;
+  char c;
+
+  n = DEFAULT_PROCS;
+  if(argc > 1)
+    n = atoi(argv[1]);
+  if(n <= 0 || n > MAXPROCS){
+    printf(1, "proctest: N debe estar entre 1 y %d\n", MAXPROCS);
+    exit();
+  }
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE TABLA DE PROCESOS - xv6\n");
+  printf(1, "========================================\n");
+  printf(1, "Procesos a crear: %d\n\n", n);
+
+  pids = malloc(n * sizeof(int));
+  if(pids == 0 || pipe(fds) < 0){
+    printf(1, "[ERROR] malloc o pipe fallo\n");
+    exit();
+  }
+
+  // FASE 1: Crear hijos bloqueados en el pipe (nadie escribe)
+  start = now_us();
+  for(i = 0; i < n; i++){
+    pid = fork();
+    if(pid < 0)
+      break;
+    if(pid == 0){
+      close(fds[1]);
+      read(fds[0], &c, 1);
+      exit();
+    }
+    pids[i] = pid;
+  }
+  report("fork", i, now_us() - start);
+  if(i < n)
+    printf(1, "  fork fallo despues de %d procesos (sin memoria)\n", i);
+  n = i;
+
+  // FASE 2: Matar a cada hijo por pid
+  killed = 0;
+  start = now_us();
+  for(i = 0; i < n; i++)
+    if(kill(pids[i]) == 0)
+      killed++;
+  report("kill", killed, now_us() - start);
+
+  // FASE 3: Recoger a todos
+  reaped = 0;
+  start = now_us();
+  while(wait() >= 0)
+    reaped++;
+  report("wait", reaped, now_us() - start);
+
+  if(killed != n || reaped != n)
+    printf(1, "[ERROR] creados %d, matados %d, recogidos %d\n",
+           n, killed, reaped);
+  close(fds[0]);
+  close(fds[1]);
+  printf(1, "========================================\n");
+  exit();
+}
@@ -0,0 +1,197 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE TIEMPO REAL (EDF) EN XV6
+// ============================================================================
+// Una tarea periódica hace un trabajo de WORK ticks de CPU cada PERIOD
+// ticks, y cada trabajo debe terminar a más tardar DEADLINE ticks después
+// de empezar su período. Mientras tanto NLOAD procesos hacen el mismo
+// cálculo que los procesos CPU-bound de schedtest. Con MLFQ la tarea cae
+// a la cola baja al gastar 5 ticks y desde ahí compite con la carga; con
+// una reserva de tiempo real (rtset) va antes que las colas MLFQ.
+//
+// FASES:
+// 1. Control de admisión: una reserva del 100% de la CPU y dos reservas
+//    del 60% tienen que rechazarse
+// 2. La tarea periódica con MLFQ, bajo carga
+// 3. La tarea periódica con reserva EDF, bajo carga
+//
+// MÉTRICAS:
+// - Plazos incumplidos sobre JOBS trabajos (medidos con uptime())
+// - Plazos incumplidos según el kernel (valor de rtwait())
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ rttest [NLOAD]
+// 2. Por defecto NLOAD = 4; debería ser al menos el número de CPUs
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+
+#define DEFAULT_LOAD 4
+#define PERIOD 10      // ticks
+#define RUNTIME 4      // ticks reservados por período
+#define DEADLINE 8     // ticks desde el inicio del período
+#define WORK 2         // ticks de CPU de cada trabajo
+#define JOBS 30
+
+int iterspertick;      // Iteraciones de cpu_work por tick (calibrado)
+
+// El mismo cálculo que schedtest
+void
+cpu_work(int iterations)
+{
+  int i, j;
+  volatile int result = 1;
+
+  for(i = 0; i < iterations; i++){
+    for(j = 1; j < 10; j++)
+      result = result * j;
+    result = 1;
+  }
+}
+
+// Medir cuántas iteraciones de cpu_work entran en un tick
+void
+calibrate(void)
+{
+  int n, start;
+
+  n = 1000;
+  for(;;){
+    sleep(1);
+    start = uptime();
+    cpu_work(n);
+    if(uptime() - start >= 10)
+      break;
+    n *= 2;
+  }
+  iterspertick = n / (uptime() - start);
+}
+
+// Carga de CPU hasta que nos maten
+void
+load(void)
+{
+  for(;;)
+    cpu_work(1000000);
+}
+
+// Ejecutar JOBS trabajos periódicos; con rt usa una reserva EDF.
+// Devuelve los plazos incumplidos.
+int
+periodic(int rt)
+{
+  int i, t0, release, misses, kmiss;
+
+  kmiss = 0;
+  if(rt){
+    if(rtset(PERIOD, RUNTIME, DEADLINE) < 0){
+      printf(1, "[ERROR] rtset rechazo la reserva\n");
+      return JOBS;
+    }
+    rtwait();          // Empezar en el borde de un período
+  } else
+    sleep(1);
+  t0 = uptime();
+  misses = 0;
+  for(i = 0; i < JOBS; i++){
+    release = t0 + i * PERIOD;
+    if(rt){
+      if(i > 0)
+        kmiss = rtwait();
+    } else {
+      while(uptime() < release)
+        sleep(release - uptime());
+    }
+    cpu_work(WORK * iterspertick);
+    if(uptime() > release + DEADLINE)
+      misses++;
+  }
+  if(rt){
+    printf(1, "  plazos incumplidos segun el kernel: %d\n", kmiss);
+    rtset(0, 0, 0);
+  }
+  return misses;
+}
+
+// Correr la tarea en un hijo nuevo (empieza en la cola alta)
+void
+run(char *label, int rt)
+{
+  int fds[2], misses;
+
+  pipe(fds);
+  if(fork() == 0){
+    close(fds[0]);
+    misses = periodic(rt);
+    write(fds[1], &misses, sizeof(misses));
+    exit();
+  }
+  close(fds[1]);
+  misses = JOBS;
+  read(fds[0], &misses, sizeof(misses));
+  close(fds[0]);
+  wait();
+  printf(1, "%s: %d de %d plazos incumplidos (%d%%)\n", label, misses,
+         JOBS, misses * 100 / JOBS);
+}
+
+int
+main(int argc, char *argv[])
+{
+  int nload, i, pid, *pids;
+
+  nload = DEFAULT_LOAD;
+  if(argc > 1)
+    nload = atoi(argv[1]);
+  if(nload < 0){
+    printf(1, "uso: rttest [NLOAD]\n");
+    exit();
+  }
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE TIEMPO REAL (EDF) - xv6\n");
+  printf(1, "========================================\n");
+  calibrate();
+  printf(1, "Periodo %d, reserva %d, plazo %d, trabajo %d ticks\n",
+         PERIOD, RUNTIME, DEADLINE, WORK);
+  printf(1, "%d procesos de carga de CPU\n\n", nload);
+
+  // FASE 1: Control de admisión
+  if(rtset(PERIOD, PERIOD, PERIOD) == 0){
+    printf(1, "[ERROR] se admitio una reserva del 100%%\n");
+    rtset(0, 0, 0);
+  }
+  if(rtset(10, 6, 10) < 0)
+    printf(1, "[ERROR] se rechazo una reserva del 60%%\n");
+  pid = fork();
+  if(pid == 0){
+    if(rtset(10, 6, 10) == 0)
+      printf(1, "[ERROR] se admitio un segundo 60%%\n");
+    exit();
+  }
+  wait();
+  rtset(0, 0, 0);
+  printf(1, "Control de admision verificado\n");
+
+  // La carga se crea antes que las tareas para quedar antes en la
+  // lista de procesos: en la cola baja gana el primero.
+  pids = malloc(nload * sizeof(int) + 1);
+  for(i = 0; i < nload; i++)
+    if((pids[i] = fork()) == 0)
+      load();
+
+  // FASE 2: MLFQ
+  run("MLFQ", 0);
+
+  // FASE 3: EDF
+  run("EDF", 1);
+
+  for(i = 0; i < nload; i++)
+    kill(pids[i]);
+  while(wait() >= 0)
+    ;
+  printf(1, "========================================\n");
+  exit();
+}
@@ -12,33 +12,59 @@
 // - Tiempo de inicio: Cuándo el proceso comienza
 // - Tiempo de fin: Cuándo el proceso termina
 // - Tiempo total: Duración completa de ejecución
+// - Latencia de I/O: cuánto tarda cada sleep(1) en volver al proceso
+//   I/O-bound (promedio y máximo), lo que mide la respuesta interactiva
+//
+// Los tiempos se miden en microsegundos con clock() desde el inicio de
+// la prueba (uptime() solo tiene resolución de 10 ms).
+//
+// Con -n se comparan procesos CPU-bound normales contra procesos con
+// nice (setpriority): los de nice empiezan en la cola baja, así que
+// los normales les ganan la CPU mientras estén en la alta y deberían
+// terminar antes aunque se creen después.
 //
 // CÓMO USARLO:
 // 1. Compilar: gcc -o schedtest schedtest.c
 // 2. Agregar a xv6 Makefile en la sección UPROGS
 // 3. Ejecutar en xv6: $ schedtest
 // 4. Comparar resultados entre Round-Robin y MLFQ
+// 5. Ejecutar en xv6: $ schedtest -n [NICE] (por omisión NICE = 10)
 // ============================================================================
 
 #include "types.h"
 #include "stat.h"
 #include "user.h"
+#include "sysinfo.h"
 
 // Número de iteraciones para cada tipo de proceso
 #define CPU_ITERATIONS 100000000   // Para proceso CPU-bound
 #define IO_ITERATIONS 50            // Para proceso I/O-bound
 #define MIXED_CPU_ITER 10000000     // CPU iterations en proceso mixto
 #define MIXED_IO_ITER 10            // I/O iterations en proceso mixto
+#define NICE_PROCS 2                // Procesos de cada grupo con -n
+#define DEFAULT_NICE 10
 
 // ============================================================================
 // FUNCIONES AUXILIARES
 // ============================================================================
 
-// Obtener el tiempo actual (en ticks del sistema)
+int test_base;   // Tiempo de inicio de la prueba (heredado por los hijos)
+
+// Obtener el tiempo actual en microsegundos
+int
+now_us(void)
+{
+  struct clockval cv;
+
+  clock(&cv);
+  return cv.sec * 1000000 + cv.nsec / 1000;
+}
+
+// Obtener el tiempo transcurrido desde el inicio de la prueba (us)
 int
 gettime(void)
 {
-  return uptime();
+  return now_us() - test_base;
 }
 
 // Realizar cálculo intensivo de CPU (factorial aproximado)
@@ -69,14 +95,14 @@ cpu_bound_process(int id)
   int start_time, end_time;
   
   start_time = gettime();
-  printf(1, "[CPU-%d] Iniciado en tick %d\n", id, start_time);
+  printf(1, "[CPU-%d] Iniciado en %d us\n", id, start_time);
   
   // Trabajo intensivo de CPU
   cpu_work(CPU_ITERATIONS);
   
   end_time = gettime();
-  printf(1, "[CPU-%d] Finalizado en tick %d (duración: %d ticks)\n", 
-         id, end_time, end_time - start_time);
+  printf(1, "[CPU-%d] Finalizado en %d us (duración: %d ms)\n", 
+         id, end_time, (end_time - start_time) / 1000);
 }
 
 // PROCESO I/O-BOUND: Hace operaciones de I/O frecuentes
@@ -86,19 +112,30 @@ void
 io_bound_process(int id)
 {
   int start_time, end_time, i;
+  int t, lat, total_lat, max_lat;
   
   start_time = gettime();
-  printf(1, "[I/O-%d] Iniciado en tick %d\n", id, start_time);
+  printf(1, "[I/O-%d] Iniciado en %d us\n", id, start_time);
   
-  // Simular I/O: alternar entre sleep y trabajo ligero
+  // Simular I/O: alternar entre sleep y trabajo ligero.
+  // Latencia = tiempo hasta volver a ejecutar después de sleep(1).
+  total_lat = 0;
+  max_lat = 0;
   for(i = 0; i < IO_ITERATIONS; i++){
+    t = now_us();
     sleep(1);  // Simula espera de I/O
+    lat = now_us() - t;
+    total_lat += lat;
+    if(lat > max_lat)
+      max_lat = lat;
     cpu_work(100000);  // Trabajo ligero al recibir datos
   }
   
   end_time = gettime();
-  printf(1, "[I/O-%d] Finalizado en tick %d (duración: %d ticks)\n", 
-         id, end_time, end_time - start_time);
+  printf(1, "[I/O-%d] Finalizado en %d us (duración: %d ms)\n", 
+         id, end_time, (end_time - start_time) / 1000);
+  printf(1, "[I/O-%d] Latencia de sleep(1): promedio %d us, maxima %d us\n",
+         id, total_lat / IO_ITERATIONS, max_lat);
 }
 
 // PROCESO MIXTO: Combina CPU y I/O
@@ -110,7 +147,7 @@ mixed_process(int id)
   int start_time, end_time, i;
   
   start_time = gettime();
-  printf(1, "[MIX-%d] Iniciado en tick %d\n", id, start_time);
+  printf(1, "[MIX-%d] Iniciado en %d us\n", id, start_time);
   
   // Alternar entre trabajo CPU e I/O
   for(i = 0; i < MIXED_IO_ITER; i++){
@@ -119,8 +156,68 @@ mixed_process(int id)
   }
   
   end_time = gettime();
-  printf(1, "[MIX-%d] Finalizado en tick %d (duración: %d ticks)\n", 
-         id, end_time, end_time - start_time);
+  printf(1, "[MIX-%d] Finalizado en %d us (duración: %d ms)\n", 
+         id, end_time, (end_time - start_time) / 1000);
+}
+
+// ============================================================================
+// COMPARACIÓN DE NICE
+// ============================================================================
+
+// Crea NICE_PROCS procesos CPU-bound con nice y después NICE_PROCS
+// normales, y muestra cuánto tardó cada grupo en promedio
+void
+nice_test(int nice)
+{
+  int i, pid, fds[2], t, sum[2];
+  int res[2];   // {1 si tiene nice, fin en us}, de cada hijo por el pipe
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE NICE - xv6\n");
+  printf(1, "========================================\n");
+  printf(1, "%d procesos CPU-bound con nice %d y %d normales\n\n",
+         NICE_PROCS, nice, NICE_PROCS);
+
+  if(pipe(fds) < 0){
+    printf(1, "Error: pipe fallo\n");
+    exit();
+  }
+  test_base = now_us();
+  for(i = 0; i < 2 * NICE_PROCS; i++){
+    pid = fork();
+    if(pid < 0){
+      printf(1, "Error: fork fallo\n");
+      exit();
+    }
+    if(pid == 0){
+      // Los primeros NICE_PROCS son los de nice
+      res[0] = i < NICE_PROCS;
+      if(res[0])
+        setpriority(0, nice);
+      cpu_work(CPU_ITERATIONS / 4);
+      res[1] = gettime();
+      write(fds[1], res, sizeof(res));
+      exit();
+    }
+  }
+  close(fds[1]);
+  sum[0] = sum[1] = 0;
+  while(read(fds[0], res, sizeof(res)) == sizeof(res)){
+    sum[res[0]] += res[1] / 1000;
+    printf(1, "[%s] Finalizado en %d ms\n",
+           res[0] ? "NICE" : "NORMAL", res[1] / 1000);
+  }
+  close(fds[0]);
+  for(i = 0; i < 2 * NICE_PROCS; i++)
+    wait();
+
+  t = getpriority(0);
+  printf(1, "\nPromedio normales: %d ms\n", sum[0] / NICE_PROCS);
+  printf(1, "Promedio con nice %d: %d ms\n", nice, sum[1] / NICE_PROCS);
+  if(t != 0)
+    printf(1, "[ERROR] el nice del padre cambio a %d\n", t);
+  printf(1, "========================================\n");
 }
 
 // ============================================================================
@@ -134,6 +231,11 @@ main(int argc, char *argv[])
   int pid;
   int i;
   
+  if(argc > 1 && strcmp(argv[1], "-n") == 0){
+    nice_test(argc > 2 ? atoi(argv[2]) : DEFAULT_NICE);
+    exit();
+  }
+
   printf(1, "\n");
   printf(1, "========================================\n");
   printf(1, "PRUEBA DE SCHEDULER - xv6\n");
@@ -149,8 +251,9 @@ main(int argc, char *argv[])
   printf(1, "========================================\n");
   printf(1, "\n");
   
+  test_base = now_us();
   test_start = gettime();
-  printf(1, "Iniciando prueba en tick %d\n\n", test_start);
+  printf(1, "Iniciando prueba en %d us\n\n", test_start);
   
   // ========================================================================
   // CREAR PROCESOS CPU-BOUND (2 procesos)
@@ -226,7 +329,7 @@ main(int argc, char *argv[])
   printf(1, "========================================\n");
   printf(1, "RESULTADOS DE LA PRUEBA\n");
   printf(1, "========================================\n");
-  printf(1, "Tiempo total de prueba: %d ticks\n", test_end - test_start);
+  printf(1, "Tiempo total de prueba: %d ms\n", (test_end - test_start) / 1000);
   printf(1, "\n");
   printf(1, "INTERPRETACION:\n");
   printf(1, "----------------------------------------\n");
@@ -0,0 +1,152 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE SENDFILE EN XV6
+// ============================================================================
+// Este programa compara dos formas de copiar un archivo grande:
+// 1. read() a un buffer de usuario y write() desde él (como el cat
+//    original, con bloques de 512 bytes y de 4 KB)
+// 2. sendfile(): el kernel mueve los datos entre los dos descriptores
+//    sin pasar por memoria de usuario
+//
+// Se mide archivo -> archivo y archivo -> pipe (un hijo vacía el pipe).
+//
+// MÉTRICAS:
+// - Throughput en KB/s
+// - Llamadas al sistema usadas (getsyscount)
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ sendtest [KB]
+// 2. Por defecto el archivo es de 1024 KB
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+#include "fcntl.h"
+
+#define DEFAULT_KB 1024
+#define BUFSIZE 4096
+
+char buf[BUFSIZE];
+
+// Copia in -> out con read/write de bloques de size bytes
+int
+copy_rw(int out, int in, int size)
+{
+  int n, total;
+
+  total = 0;
+  while((n = read(in, buf, size)) > 0){
+    if(write(out, buf, n) != n)
+      return -1;
+    total += n;
+  }
+  return total;
+}
+
+// Copia in -> out con sendfile
+int
+copy_send(int out, int in, int size)
+{
+  int n, total;
+
+  total = 0;
+  while((n = sendfile(out, in, 65536)) > 0)
+    total += n;
+  return n < 0 ? -1 : total;
+}
+
+void
+report(char *what, int kb, int ticks, int calls)
+{
+  if(ticks == 0)
+    ticks = 1;
+  printf(1, "%s: %d ticks (~%d KB/s), %d syscalls\n", what, ticks,
+         kb * 100 / ticks, calls);
+}
+
+// Mide una copia del archivo "sendsrc" con la función copy:
+// a otro archivo (topipe = 0) o a un pipe (topipe = 1)
+void
+measure(char *what, int (*copy)(int, int, int), int size, int topipe, int kb)
+{
+  int in, out, p[2], start, calls, n;
+
+  if((in = open("sendsrc", O_RDONLY)) < 0){
+    printf(1, "[ERROR] No se pudo abrir sendsrc\n");
+    exit();
+  }
+  if(topipe){
+    pipe(p);
+    if(fork() == 0){
+      close(p[1]);
+      while(read(p[0], buf, BUFSIZE) > 0)
+        ;
+      exit();
+    }
+    close(p[0]);
+    out = p[1];
+  } else {
+    unlink("senddst");
+    if((out = open("senddst", O_CREATE|O_WRONLY)) < 0){
+      printf(1, "[ERROR] No se pudo crear senddst\n");
+      exit();
+    }
+  }
+
+  start = uptime();
+  calls = getsyscount();
+  n = copy(out, in, size);
+  calls = getsyscount() - calls - 1;
+  close(out);
+  if(topipe)
+    wait();
+  close(in);
+  if(n != kb * 1024)
+    printf(1, "[ERROR] %s copio %d bytes\n", what, n);
+  report(what, kb, uptime() - start, calls);
+}
+
+int
+main(int argc, char *argv[])
+{
+  int kb, i, fd;
+
+  kb = DEFAULT_KB;
+  if(argc > 1)
+    kb = atoi(argv[1]);
+  if(kb <= 0){
+    printf(1, "sendtest: tamaño invalido\n");
+    exit();
+  }
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE SENDFILE - xv6\n");
+  printf(1, "========================================\n");
+  printf(1, "Archivo de %d KB\n\n", kb);
+
+  memset(buf, 's', sizeof(buf));
+  fd = open("sendsrc", O_CREATE|O_WRONLY);
+  if(fd < 0){
+    printf(1, "[ERROR] No se pudo crear sendsrc\n");
+    exit();
+  }
+  for(i = 0; i < kb / 4; i++)
+    write(fd, buf, BUFSIZE);
+  close(fd);
+  kb = kb / 4 * 4;
+
+  printf(1, "Archivo -> archivo\n");
+  measure("  read/write 512 B", copy_rw, 512, 0, kb);
+  measure("  read/write 4 KB", copy_rw, 4096, 0, kb);
+  measure("  sendfile", copy_send, 0, 0, kb);
+  printf(1, "Archivo -> pipe\n");
+  measure("  read/write 512 B", copy_rw, 512, 1, kb);
+  measure("  read/write 4 KB", copy_rw, 4096, 1, kb);
+  measure("  sendfile", copy_send, 0, 1, kb);
+
+  unlink("sendsrc");
+  unlink("senddst");
+  printf(1, "========================================\n");
+  exit();
+}
@@ -16,6 +16,7 @@ initsleeplock(struct sleeplock *lk, char *name)
   initlock(&lk->lk, "sleep lock");
   lk->name = name;
   lk->locked = 0;
+  lk->boosted = 0;
   lk->pid = 0;
 }
 
@@ -24,6 +25,9 @@ acquiresleep(struct sleeplock *lk)
 {
   acquire(&lk->lk);
   while (lk->locked) {
+    // Lend our priority to the holder (priority inheritance).
+    if(!lk->boosted && boostproc(lk->pid))
+      lk->boosted = 1;
     sleep(lk, &lk->lk);
   }
   lk->locked = 1;
@@ -35,6 +39,10 @@ void
 releasesleep(struct sleeplock *lk)
 {
   acquire(&lk->lk);
+  if(lk->boosted){
+    lk->boosted = 0;
+    unboostproc();
+  }
   lk->locked = 0;
   lk->pid = 0;
   wakeup(lk);
@@ -1,6 +1,7 @@
 // Long-term locks for processes
 struct sleeplock {
   uint locked;       // Is the lock held?
+  int boosted;       // Holder runs at a waiter's priority
   struct spinlock lk; // spinlock protecting this sleep lock
   
   // For debugging:
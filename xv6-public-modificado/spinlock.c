@@ -8,13 +8,45 @@
 #include "mmu.h"
 #include "proc.h"
 #include "spinlock.h"
+#include "lockstat.h"
+
+// Lock statistics, by lock name. Each CPU counts in its own
+// row, so acquire() and release() update them without atomic
+// instructions or shared cache lines; lockstat() adds the rows.
+static char statname[NLOCKSTAT][16];
+static int nstat;
+static uint statguard;      // protects statname and nstat
+static struct lockstat counts[NCPU][NLOCKSTAT];
+
+// Find or add the statistics slot for name.
+static int
+lockstatslot(char *name)
+{
+  int i;
+
+  while(xchg(&statguard, 1) != 0)
+    ;
+  for(i = 0; i < nstat; i++)
+    if(strncmp(statname[i], name, sizeof(statname[i])) == 0)
+      break;
+  if(i == nstat){
+    if(nstat < NLOCKSTAT)
+      safestrcpy(statname[nstat++], name, sizeof(statname[0]));
+    else
+      i = -1;
+  }
+  xchg(&statguard, 0);
+  return i;
+}
 
 void
 initlock(struct spinlock *lk, char *name)
 {
   lk->name = name;
-  lk->locked = 0;
+  lk->next = 0;
+  lk->owner = 0;
   lk->cpu = 0;
+  lk->stat = lockstatslot(name);
 }
 
 // Acquire the lock.
@@ -24,13 +56,20 @@ initlock(struct spinlock *lk, char *name)
 void
 acquire(struct spinlock *lk)
 {
+  uint ticket, spins;
+  struct lockstat *st;
+
   pushcli(); // disable interrupts to avoid deadlock.
   if(holding(lk))
     panic("acquire");
 
-  // The xchg is atomic.
-  while(xchg(&lk->locked, 1) != 0)
-    ;
+  // The xadd is atomic; each CPU gets a different ticket.
+  ticket = xadd(&lk->next, 1);
+  spins = 0;
+  while(*(volatile uint*)&lk->owner != ticket){
+    pause();
+    spins++;
+  }
 
   // Tell the C compiler and the processor to not move loads or stores
   // past this point, to ensure that the critical section's memory
@@ -40,15 +79,35 @@ acquire(struct spinlock *lk)
   // Record info about lock acquisition for debugging.
   lk->cpu = mycpu();
   getcallerpcs(&lk, lk->pcs);
+
+  if(lk->stat >= 0){
+    st = &counts[lk->cpu - cpus][lk->stat];
+    st->nacquire++;
+    if(spins){
+      st->ncontend++;
+      st->nspin += spins;
+    }
+    lk->tsc = rdtsc();
+  }
 }
 
 // Release the lock.
 void
 release(struct spinlock *lk)
 {
+  struct lockstat *st;
+  uint hold;
+
   if(!holding(lk))
     panic("release");
 
+  if(lk->stat >= 0){
+    st = &counts[lk->cpu - cpus][lk->stat];
+    hold = rdtsc() - lk->tsc;
+    if(hold > st->maxhold)
+      st->maxhold = hold;
+  }
+
   lk->pcs[0] = 0;
   lk->cpu = 0;
 
@@ -59,10 +118,10 @@ release(struct spinlock *lk)
   // stores; __sync_synchronize() tells them both not to.
   __sync_synchronize();
 
-  // Release the lock, equivalent to lk->locked = 0.
-  // This code can't use a C assignment, since it might
-  // not be atomic. A real OS would use C atomics here.
-  asm volatile("movl $0, %0" : "+m" (lk->locked) : );
+  // Hand the lock to the next ticket. Only the holder writes
+  // owner, so a plain store of owner+1 is enough; it must be a
+  // single movl, which a C assignment does not promise.
+  asm volatile("movl %1, %0" : "+m" (lk->owner) : "r" (lk->owner + 1));
 
   popcli();
 }
@@ -91,7 +150,7 @@ holding(struct spinlock *lock)
 {
   int r;
   pushcli();
-  r = lock->locked && lock->cpu == mycpu();
+  r = lock->owner != lock->next && lock->cpu == mycpu();
   popcli();
   return r;
 }
@@ -124,3 +183,30 @@ popcli(void)
     sti();
 }
 
+// Copy up to n lock statistics entries to ls, summing the
+// per-CPU counts, and return how many were copied. Then, if
+// reset is set, clear the counts.
+int
+lockstats(struct lockstat *ls, int n, int reset)
+{
+  int i, c;
+  struct lockstat *st;
+
+  if(n > nstat)
+    n = nstat;
+  for(i = 0; i < n; i++){
+    memset(&ls[i], 0, sizeof(ls[i]));
+    safestrcpy(ls[i].name, statname[i], sizeof(ls[i].name));
+    for(c = 0; c < ncpu; c++){
+      st = &counts[c][i];
+      ls[i].nacquire += st->nacquire;
+      ls[i].ncontend += st->ncontend;
+      ls[i].nspin += st->nspin;
+      if(st->maxhold > ls[i].maxhold)
+        ls[i].maxhold = st->maxhold;
+    }
+  }
+  if(reset)
+    memset(counts, 0, sizeof(counts));
+  return n;
+}
@@ -1,11 +1,18 @@
 // Mutual exclusion lock.
+// A ticket lock: acquire() takes the next ticket and waits until
+// owner reaches it, so CPUs get the lock in arrival order.
 struct spinlock {
-  uint locked;       // Is the lock held?
+  uint next;         // Next ticket to hand out.
+  uint owner;        // Ticket that holds the lock.
 
   // For debugging:
   char *name;        // Name of lock.
   struct cpu *cpu;   // The cpu holding the lock.
   uint pcs[10];      // The call stack (an array of program counters)
                      // that locked the lock.
+
+  // For lockstat():
+  int stat;          // Index in the statistics table, -1 if none.
+  uint tsc;          // TSC when acquired.
 };
 
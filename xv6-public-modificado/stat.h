@@ -9,3 +9,16 @@ struct stat {
   short nlink; // Number of links to file
   uint size;   // Size of file in bytes
 };
+
+// File system statistics (see fsstat()).
+struct fsstat {
+  uint size;       // Size of file system image (blocks)
+  uint nfree;      // Number of free blocks
+  uint nfreeext;   // Number of runs of contiguous free blocks
+  uint maxfreeext; // Length of the longest free run
+  uint nchits;     // Name cache lookups that hit
+  uint ncmisses;   // Name cache lookups that had to read the directory
+  uint ninode;     // Entries in the inode cache
+  uint ichits;     // iget() calls that found the inode cached
+  uint icmisses;   // iget() calls that had to use a new entry
+};
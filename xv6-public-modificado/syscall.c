@@ -103,6 +103,23 @@ extern int sys_unlink(void);
 extern int sys_wait(void);
 extern int sys_write(void);
 extern int sys_uptime(void);
+extern int sys_fsstat(void);
+extern int sys_getsyscount(void);
+extern int sys_getcswitch(void);
+extern int sys_sendfile(void);
+extern int sys_readv(void);
+extern int sys_writev(void);
+extern int sys_batch(void);
+extern int sys_clock(void);
+extern int sys_lockstat(void);
+extern int sys_clone(void);
+extern int sys_join(void);
+extern int sys_futex(void);
+extern int sys_kstackuse(void);
+extern int sys_rtset(void);
+extern int sys_rtwait(void);
+extern int sys_getpriority(void);
+extern int sys_setpriority(void);
 
 static int (*syscalls[])(void) = {
 [SYS_fork]    sys_fork,
@@ -126,6 +143,23 @@ static int (*syscalls[])(void) = {
 [SYS_link]    sys_link,
 [SYS_mkdir]   sys_mkdir,
 [SYS_close]   sys_close,
+[SYS_fsstat]  sys_fsstat,
+[SYS_getsyscount] sys_getsyscount,
+[SYS_getcswitch] sys_getcswitch,
+[SYS_sendfile] sys_sendfile,
+[SYS_readv]   sys_readv,
+[SYS_writev]  sys_writev,
+[SYS_batch]   sys_batch,
+[SYS_clock]   sys_clock,
+[SYS_lockstat] sys_lockstat,
+[SYS_clone]   sys_clone,
+[SYS_join]    sys_join,
+[SYS_futex]   sys_futex,
+[SYS_kstackuse] sys_kstackuse,
+[SYS_rtset]   sys_rtset,
+[SYS_rtwait]  sys_rtwait,
+[SYS_getpriority] sys_getpriority,
+[SYS_setpriority] sys_setpriority,
 };
 
 void
@@ -135,6 +169,7 @@ syscall(void)
   struct proc *curproc = myproc();
 
   num = curproc->tf->eax;
+  curproc->nsyscall++;
   if(num > 0 && num < NELEM(syscalls) && syscalls[num]) {
     curproc->tf->eax = syscalls[num]();
   } else {
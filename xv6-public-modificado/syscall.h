@@ -20,3 +20,20 @@
 #define SYS_link   19
 #define SYS_mkdir  20
 #define SYS_close  21
+#define SYS_fsstat 22
+#define SYS_getsyscount 23
+#define SYS_getcswitch 24
+#define SYS_sendfile 25
+#define SYS_readv  26
+#define SYS_writev 27
+#define SYS_batch  28
+#define SYS_clock  29
+#define SYS_lockstat 30
+#define SYS_clone  31
+#define SYS_join   32
+#define SYS_futex  33
+#define SYS_kstackuse 34
+#define SYS_rtset  35
+#define SYS_rtwait 36
+#define SYS_getpriority 37
+#define SYS_setpriority 38
@@ -0,0 +1,72 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE LATENCIA DE LLAMADAS AL SISTEMA EN XV6
+// ============================================================================
+// Este programa mide el costo de entrar y salir del kernel con llamadas
+// al sistema triviales (getpid y uptime), por las dos entradas:
+// 1. int $T_SYSCALL (vector 64): la CPU guarda el estado con la puerta
+//    de interrupción y vuelve con iret
+// 2. sysenter/sysexit: entrada rápida usada ahora por todas las
+//    llamadas de usys.S
+// 3. Sin llamada: upid(), uticks() y utime() leen las páginas de solo
+//    lectura que el kernel mapea en cada proceso (sysinfo.h)
+//
+// MÉTRICAS:
+// - Llamadas por segundo
+// - Nanosegundos aproximados por llamada (1 tick = ~10 ms)
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ syscalltest [N]
+// 2. Por defecto N = 1000000 llamadas por medición
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+
+#define DEFAULT_CALLS 1000000
+
+void
+measure(char *what, int (*call)(void), int n)
+{
+  int i, start, ticks;
+
+  start = uptime();
+  for(i = 0; i < n; i++)
+    call();
+  ticks = uptime() - start;
+  if(ticks == 0)
+    ticks = 1;
+  printf(1, "%s: %d llamadas en %d ticks (~%d ns por llamada)\n",
+         what, n, ticks, ticks * 10000 / (n / 1000));
+}
+
+int
+main(int argc, char *argv[])
+{
+  int n;
+
+  n = DEFAULT_CALLS;
+  if(argc > 1)
+    n = atoi(argv[1]);
+  if(n < 1000){
+    printf(1, "syscalltest: N debe ser al menos 1000\n");
+    exit();
+  }
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE LATENCIA DE SYSCALLS - xv6\n");
+  printf(1, "========================================\n");
+  if(getpid() != getpid_int() || getpid() != upid())
+    printf(1, "[ERROR] getpid difiere entre las entradas\n");
+
+  measure("getpid con int 0x40 ", getpid_int, n);
+  measure("getpid con sysenter ", getpid, n);
+  measure("uptime con int 0x40 ", uptime_int, n);
+  measure("uptime con sysenter ", uptime, n);
+  measure("pid sin syscall      ", upid, n);
+  measure("ticks sin syscall    ", (int(*)(void))uticks, n);
+  measure("tiempo us sin syscall", (int(*)(void))utime, n);
+  printf(1, "========================================\n");
+  exit();
+}
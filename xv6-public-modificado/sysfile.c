@@ -15,6 +15,7 @@
 #include "sleeplock.h"
 #include "file.h"
 #include "fcntl.h"
+#include "uio.h"
 
 // Fetch the nth word-sized system call argument as a file descriptor
 // and return both the descriptor and the corresponding struct file.
@@ -90,6 +91,18 @@ sys_write(void)
   return filewrite(f, p, n);
 }
 
+// Move up to n bytes from fd in to fd out inside the kernel.
+int
+sys_sendfile(void)
+{
+  struct file *out, *in;
+  int n;
+
+  if(argfd(0, 0, &out) < 0 || argfd(1, 0, &in) < 0 || argint(2, &n) < 0)
+    return -1;
+  return filesend(out, in, n);
+}
+
 int
 sys_close(void)
 {
@@ -114,6 +127,18 @@ sys_fstat(void)
   return filestat(f, st);
 }
 
+// Return statistics of the root file system.
+int
+sys_fsstat(void)
+{
+  struct fsstat *st;
+
+  if(argptr(0, (void*)&st, sizeof(*st)) < 0)
+    return -1;
+  fsstat(ROOTDEV, st);
+  return 0;
+}
+
 // Create the path new as a link to the same inode as old.
 int
 sys_link(void)
@@ -181,23 +206,19 @@ isdirempty(struct inode *dp)
 }
 
 //PAGEBREAK!
-int
-sys_unlink(void)
+// Remove the directory entry path.
+// Runs inside the caller's log transaction.
+static int
+dounlink(char *path)
 {
   struct inode *ip, *dp;
   struct dirent de;
-  char name[DIRSIZ], *path;
+  char name[DIRSIZ];
   uint off;
 
-  if(argstr(0, &path) < 0)
+  if((dp = nameiparent(path, name)) == 0)
     return -1;
 
-  begin_op();
-  if((dp = nameiparent(path, name)) == 0){
-    end_op();
-    return -1;
-  }
-
   ilock(dp);
 
   // Cannot unlink "." or "..".
@@ -218,6 +239,7 @@ sys_unlink(void)
   memset(&de, 0, sizeof(de));
   if(writei(dp, (char*)&de, off, sizeof(de)) != sizeof(de))
     panic("unlink: writei");
+  ncremove(dp, name);
   if(ip->type == T_DIR){
     dp->nlink--;
     iupdate(dp);
@@ -227,17 +249,27 @@ sys_unlink(void)
   ip->nlink--;
   iupdate(ip);
   iunlockput(ip);
-
-  end_op();
-
   return 0;
 
 bad:
   iunlockput(dp);
-  end_op();
   return -1;
 }
 
+int
+sys_unlink(void)
+{
+  char *path;
+  int r;
+
+  if(argstr(0, &path) < 0)
+    return -1;
+  begin_op();
+  r = dounlink(path);
+  end_op();
+  return r;
+}
+
 static struct inode*
 create(char *path, short type, short major, short minor)
 {
@@ -282,34 +314,25 @@ create(char *path, short type, short major, short minor)
   return ip;
 }
 
-int
-sys_open(void)
+// Open path and return a new fd.
+// Runs inside the caller's log transaction.
+static int
+doopen(char *path, int omode)
 {
-  char *path;
-  int fd, omode;
+  int fd;
   struct file *f;
   struct inode *ip;
 
-  if(argstr(0, &path) < 0 || argint(1, &omode) < 0)
-    return -1;
-
-  begin_op();
-
   if(omode & O_CREATE){
     ip = create(path, T_FILE, 0, 0);
-    if(ip == 0){
-      end_op();
+    if(ip == 0)
       return -1;
-    }
   } else {
-    if((ip = namei(path)) == 0){
-      end_op();
+    if((ip = namei(path)) == 0)
       return -1;
-    }
     ilock(ip);
     if(ip->type == T_DIR && omode != O_RDONLY){
       iunlockput(ip);
-      end_op();
       return -1;
     }
   }
@@ -318,11 +341,9 @@ sys_open(void)
     if(f)
       fileclose(f);
     iunlockput(ip);
-    end_op();
     return -1;
   }
   iunlock(ip);
-  end_op();
 
   f->type = FD_INODE;
   f->ip = ip;
@@ -333,21 +354,46 @@ sys_open(void)
 }
 
 int
-sys_mkdir(void)
+sys_open(void)
 {
   char *path;
-  struct inode *ip;
+  int fd, omode;
 
+  if(argstr(0, &path) < 0 || argint(1, &omode) < 0)
+    return -1;
   begin_op();
-  if(argstr(0, &path) < 0 || (ip = create(path, T_DIR, 0, 0)) == 0){
-    end_op();
+  fd = doopen(path, omode);
+  end_op();
+  return fd;
+}
+
+// Create directory path.
+// Runs inside the caller's log transaction.
+static int
+domkdir(char *path)
+{
+  struct inode *ip;
+
+  if((ip = create(path, T_DIR, 0, 0)) == 0)
     return -1;
-  }
   iunlockput(ip);
-  end_op();
   return 0;
 }
 
+int
+sys_mkdir(void)
+{
+  char *path;
+  int r;
+
+  if(argstr(0, &path) < 0)
+    return -1;
+  begin_op();
+  r = domkdir(path);
+  end_op();
+  return r;
+}
+
 int
 sys_mknod(void)
 {
@@ -442,3 +488,171 @@ sys_pipe(void)
   fd[1] = fd1;
   return 0;
 }
+
+//PAGEBREAK!
+// Vectored and batched I/O.
+
+// Check that [p, p+n) lies within the process address space.
+static int
+checkuser(void *p, int n)
+{
+  struct proc *curproc = myproc();
+
+  if(n < 0 || (uint)p >= curproc->sz || (uint)p+n > curproc->sz)
+    return -1;
+  return 0;
+}
+
+// Fetch the nth argument as an array of cnt iovecs and
+// check each buffer.
+static int
+argiov(int n, int cnt, struct iovec **piov)
+{
+  struct iovec *iov;
+  int i;
+
+  if(cnt < 0 || cnt > UIO_MAXIOV ||
+     argptr(n, (void*)&iov, cnt*sizeof(*iov)) < 0)
+    return -1;
+  for(i = 0; i < cnt; i++)
+    if(checkuser(iov[i].base, iov[i].len) < 0)
+      return -1;
+  *piov = iov;
+  return 0;
+}
+
+int
+sys_readv(void)
+{
+  struct file *f;
+  struct iovec *iov;
+  int cnt;
+
+  if(argfd(0, 0, &f) < 0 || argint(2, &cnt) < 0 || argiov(1, cnt, &iov) < 0)
+    return -1;
+  return filereadv(f, iov, cnt);
+}
+
+int
+sys_writev(void)
+{
+  struct file *f;
+  struct iovec *iov;
+  int cnt;
+
+  if(argfd(0, 0, &f) < 0 || argint(2, &cnt) < 0 || argiov(1, cnt, &iov) < 0)
+    return -1;
+  return filewritev(f, iov, cnt);
+}
+
+// Can op on file f share a log transaction with its neighbours?
+// Pipe and device I/O may block and big writes need several
+// transactions.
+static int
+batchtx(struct batchop *op, struct file *f)
+{
+  if(op->op == BOP_READ)
+    return f && f->type == FD_INODE && f->ip->type != T_DEV;
+  if(op->op == BOP_WRITE)
+    return f && f->type == FD_INODE && op->n <= FILEWRITEMAX;
+  return 1;
+}
+
+// Run one batch operation other than BOP_CLOSE.
+// tx says whether the caller holds a log transaction for it.
+static int
+batchrun(struct batchop *op, struct file *f, int tx)
+{
+  char *path;
+
+  switch(op->op){
+  case BOP_OPEN:
+  case BOP_MKDIR:
+  case BOP_UNLINK:
+    if(fetchstr((uint)op->path, &path) < 0)
+      return -1;
+    if(op->op == BOP_OPEN)
+      return doopen(path, op->n);
+    if(op->op == BOP_MKDIR)
+      return domkdir(path);
+    return dounlink(path);
+  case BOP_READ:
+    if(f == 0 || checkuser(op->buf, op->n) < 0)
+      return -1;
+    return fileread(f, op->buf, op->n);
+  case BOP_WRITE:
+    if(f == 0 || checkuser(op->buf, op->n) < 0)
+      return -1;
+    if(tx)
+      return filewritetx(f, op->buf, op->n);
+    return filewrite(f, op->buf, op->n);
+  case BOP_FSTAT:
+    if(f == 0 || checkuser(op->buf, sizeof(struct stat)) < 0)
+      return -1;
+    return filestat(f, op->buf);
+  }
+  return -1;
+}
+
+// Run an array of n file operations in one system call.
+// Consecutive operations share a log transaction, up to as many
+// as the log has room for. Files closed inside a transaction are
+// released after it ends, because fileclose() may start its own.
+// Stops at the first failing operation; returns the number of
+// operations that succeeded.
+int
+sys_batch(void)
+{
+  struct batchop *ops, *op;
+  struct file *f, *closing[BATCHMAX];
+  struct proc *curproc = myproc();
+  int n, i, fd, lastfd, reserved, used, nclosing;
+
+  if(argint(1, &n) < 0 || n < 0 || n > BATCHMAX ||
+     argptr(0, (void*)&ops, n*sizeof(*ops)) < 0)
+    return -1;
+
+  lastfd = -1;
+  reserved = used = nclosing = 0;
+  for(i = 0; i < n; i++){
+    op = &ops[i];
+    fd = op->fd < 0 ? lastfd : op->fd;
+    f = fd >= 0 && fd < NOFILE ? curproc->ofile[fd] : 0;
+
+    if(reserved && (used == reserved || !batchtx(op, f))){
+      end_opn(reserved);
+      reserved = 0;
+      while(nclosing > 0)
+        fileclose(closing[--nclosing]);
+    }
+    if(!reserved && batchtx(op, f)){
+      reserved = begin_opn(n - i);
+      used = 0;
+    }
+    if(reserved)
+      used++;
+
+    if(op->op == BOP_CLOSE){
+      op->ret = -1;
+      if(f){
+        curproc->ofile[fd] = 0;
+        if(reserved)
+          closing[nclosing++] = f;
+        else
+          fileclose(f);
+        op->ret = 0;
+      }
+    } else
+      op->ret = batchrun(op, f, reserved != 0);
+
+    if(op->op == BOP_OPEN && op->ret >= 0)
+      lastfd = op->ret;
+    if(op->ret < 0)
+      break;
+  }
+  if(reserved)
+    end_opn(reserved);
+  while(nclosing > 0)
+    fileclose(closing[--nclosing]);
+  return i;
+}
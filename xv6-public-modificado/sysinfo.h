@@ -0,0 +1,25 @@
+// Read-only pages the kernel maps into every process, so user
+// code can read the time and its pid without a system call.
+//   USYSINFO:          struct sysinfo, one page shared by all
+//   USYSINFO+PGSIZE:   struct procinfo, one page per process
+// User memory ends below USYSINFO.
+
+#define USYSINFO 0x7FFFE000   // KERNBASE - 2*PGSIZE
+
+struct sysinfo {
+  volatile uint seq;      // odd while the kernel updates the rest
+  volatile uint ticks;    // timer interrupts since boot
+  volatile uint usec;     // microseconds since boot at the last tick
+  volatile uint tsc;      // low 32 bits of the TSC at the last tick
+  volatile uint tscperus; // TSC cycles per microsecond, 0 if unknown
+};
+
+struct procinfo {
+  uint pid;
+};
+
+// Time since boot, filled in by clock().
+struct clockval {
+  uint sec;
+  uint nsec;              // < 1000000000
+};
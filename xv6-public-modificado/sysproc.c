@@ -6,6 +6,9 @@
 #include "memlayout.h"
 #include "mmu.h"
 #include "proc.h"
+#include "sysinfo.h"
+#include "lockstat.h"
+#include "futex.h"
 
 int
 sys_fork(void)
@@ -13,6 +16,29 @@ sys_fork(void)
   return fork();
 }
 
+// create a thread running fn(arg) on a one-page stack.
+int
+sys_clone(void)
+{
+  char *fn, *arg, *stack;
+
+  if(argint(0, (int*)&fn) < 0 || argint(1, (int*)&arg) < 0 ||
+     argptr(2, &stack, PGSIZE) < 0)
+    return -1;
+  return clone((void(*)(void*))fn, arg, stack);
+}
+
+// wait for a thread to exit; return its pid and stack.
+int
+sys_join(void)
+{
+  void **stack;
+
+  if(argptr(0, (void*)&stack, sizeof(*stack)) < 0)
+    return -1;
+  return join(stack);
+}
+
 int
 sys_exit(void)
 {
@@ -50,8 +76,9 @@ sys_sbrk(void)
 
   if(argint(0, &n) < 0)
     return -1;
-  addr = myproc()->sz;
-  if(growproc(n) < 0)
+  // growproc() reads the old size under its lock, so threads
+  // calling sbrk() at once never get the same address.
+  if((addr = growproc(n)) < 0)
     return -1;
   return addr;
 }
@@ -89,3 +116,118 @@ sys_uptime(void)
   release(&tickslock);
   return xticks;
 }
+
+// return how many system calls the current process has made,
+// including this one.
+int
+sys_getsyscount(void)
+{
+  return myproc()->nsyscall;
+}
+
+// return how many times the current process has given up
+// the CPU (slept, yielded or been preempted).
+int
+sys_getcswitch(void)
+{
+  return myproc()->nswitch;
+}
+
+// return the time since boot with nanosecond resolution.
+int
+sys_clock(void)
+{
+  struct clockval *cv;
+
+  if(argptr(0, (void*)&cv, sizeof(*cv)) < 0)
+    return -1;
+  clockread(&cv->sec, &cv->nsec);
+  return 0;
+}
+
+// copy lock statistics to user space, optionally clearing them.
+int
+sys_lockstat(void)
+{
+  struct lockstat *ls;
+  int n, reset;
+
+  if(argint(1, &n) < 0 || argint(2, &reset) < 0 || n < 0)
+    return -1;
+  if(n > NLOCKSTAT)
+    n = NLOCKSTAT;
+  if(argptr(0, (void*)&ls, n*sizeof(*ls)) < 0)
+    return -1;
+  return lockstats(ls, n, reset);
+}
+
+// sleep on, or wake sleepers on, a word of user memory.
+int
+sys_futex(void)
+{
+  char *addr;
+  int op, val;
+
+  if(argptr(0, &addr, sizeof(uint)) < 0 || argint(1, &op) < 0 ||
+     argint(2, &val) < 0)
+    return -1;
+  switch(op){
+  case FUTEX_WAIT:
+    return futexwait((uint)addr, val);
+  case FUTEX_WAKE:
+    return futexwake((uint)addr, val);
+  }
+  return -1;
+}
+
+// kernel stack high-water mark of a process, in bytes.
+int
+sys_kstackuse(void)
+{
+  int pid;
+
+  if(argint(0, &pid) < 0)
+    return -1;
+  return kstackuse(pid);
+}
+
+// reserve CPU time as a real-time (EDF) process.
+int
+sys_rtset(void)
+{
+  int period, runtime, deadline;
+
+  if(argint(0, &period) < 0 || argint(1, &runtime) < 0 ||
+     argint(2, &deadline) < 0)
+    return -1;
+  return rtset(period, runtime, deadline);
+}
+
+// end this period's job and wait for the next period.
+int
+sys_rtwait(void)
+{
+  return rtwait();
+}
+
+// nice value of a process (0: the caller).
+int
+sys_getpriority(void)
+{
+  int pid;
+
+  if(argint(0, &pid) < 0)
+    return -1;
+  return getpriority(pid);
+}
+
+// set the nice value of a process (0: the caller).
+int
+sys_setpriority(void)
+{
+  int pid, nice;
+
+  if(argint(0, &pid) < 0 || argint(1, &nice) < 0)
+    return -1;
+  return setpriority(pid, nice);
+}
@@ -0,0 +1,153 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE HILOS EN XV6
+// ============================================================================
+// Este programa reparte un cálculo entre T hilos que comparten memoria
+// (clone/join, biblioteca uthread). Cada hilo cuenta los primos de su
+// parte del rango [2, N) y suma su resultado a un total compartido
+// protegido con un lock. Con procesos (fork) cada trabajador copiaría
+// todo el espacio de direcciones y el resultado tendría que volver por
+// un pipe.
+//
+// MÉTRICAS:
+// - Tiempo con 1, 2, 4, ... T hilos (clock(), en ms)
+// - Aceleración respecto de 1 hilo (x100)
+// - Tiempo de crear y recoger un hilo vacío contra fork + wait
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ threadtest [N] [T]
+// 2. Por defecto N = 200000 y T = 8
+// 3. Ejecutar qemu con CPUS=1, 2 y 4: la aceleración debería seguir al
+//    número de CPUs
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+#include "sysinfo.h"
+#include "uthread.h"
+
+#define DEFAULT_N 200000
+#define DEFAULT_T 8
+#define MAXTHREADS 16
+#define SPAWNS 200
+
+int limit;                // Contar primos en [2, limit)
+int nthreads;
+int total;                // Resultado compartido
+struct lock totallock;
+
+int
+now_us(void)
+{
+  struct clockval cv;
+
+  clock(&cv);
+  return cv.sec * 1000000 + cv.nsec / 1000;
+}
+
+int
+isprime(int n)
+{
+  int d;
+
+  if(n < 2)
+    return 0;
+  for(d = 2; d * d <= n; d++)
+    if(n % d == 0)
+      return 0;
+  return 1;
+}
+
+// El hilo k cuenta los números k, k+T, k+2T, ... para repartir parejo
+void
+worker(void *arg)
+{
+  int k, n, count;
+
+  k = (int)arg;
+  count = 0;
+  for(n = k; n < limit; n += nthreads)
+    count += isprime(n);
+  lock_acquire(&totallock);
+  total += count;
+  lock_release(&totallock);
+}
+
+void
+nothing(void *arg)
+{
+}
+
+// Cuenta los primos con t hilos y devuelve el tiempo en us
+int
+run(int t)
+{
+  int k, start, created;
+
+  nthreads = t;
+  total = 0;
+  created = 0;
+  start = now_us();
+  for(k = 0; k < t; k++)
+    if(thread_create(worker, (void*)k) >= 0)
+      created++;
+  while(thread_join() >= 0)
+    ;
+  if(created != t)
+    printf(1, "[ERROR] solo se crearon %d hilos\n", created);
+  return now_us() - start;
+}
+
+int
+main(int argc, char *argv[])
+{
+  int maxt, t, us, base, primes, i, start;
+
+  limit = DEFAULT_N;
+  maxt = DEFAULT_T;
+  if(argc > 1)
+    limit = atoi(argv[1]);
+  if(argc > 2)
+    maxt = atoi(argv[2]);
+  if(limit < 2 || maxt < 1 || maxt > MAXTHREADS){
+    printf(1, "uso: threadtest [N] [T], T entre 1 y %d\n", MAXTHREADS);
+    exit();
+  }
+  lock_init(&totallock);
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE HILOS - xv6\n");
+  printf(1, "========================================\n");
+  printf(1, "Contando primos menores que %d\n\n", limit);
+
+  base = run(1);
+  primes = total;
+  printf(1, "1 hilo: %d primos en %d ms\n", primes, base / 1000);
+  for(t = 2; t <= maxt; t *= 2){
+    us = run(t);
+    printf(1, "%d hilos: %d primos en %d ms (aceleracion x%d/100)\n",
+           t, total, us / 1000, us > 0 ? base / (us / 100 + 1) : 0);
+    if(total != primes)
+      printf(1, "[ERROR] el resultado cambio con %d hilos\n", t);
+  }
+
+  // Costo de crear un trabajador
+  printf(1, "\n");
+  start = now_us();
+  for(i = 0; i < SPAWNS; i++){
+    thread_create(nothing, 0);
+    thread_join();
+  }
+  printf(1, "thread_create + thread_join: %d us c/u\n",
+         (now_us() - start) / SPAWNS);
+  start = now_us();
+  for(i = 0; i < SPAWNS; i++){
+    if(fork() == 0)
+      exit();
+    wait();
+  }
+  printf(1, "fork + wait: %d us c/u\n", (now_us() - start) / SPAWNS);
+  printf(1, "========================================\n");
+  exit();
+}
@@ -13,6 +13,27 @@ struct gatedesc idt[256];
 extern uint vectors[];  // in vectors.S: array of 256 entry pointers
 struct spinlock tickslock;
 uint ticks;
+int havesep;   // CPU has sysenter; if not, trap() emulates it
+
+// Running off a kernel stack faults with %esp in the guard page,
+// where the CPU cannot push the page fault's trap frame, so it
+// raises a double fault instead. Double faults go through a task
+// gate to dblfault(), which gets its own stack from dfts.
+static struct taskstate dfts[NCPU];
+static char dfstack[NCPU][PGSIZE];
+
+static void
+dblfault(void)
+{
+  struct taskstate *ts;
+
+  ts = &mycpu()->ts;   // state saved by the task switch
+  cprintf("double fault on cpu %d eip %x esp %x\n",
+          cpuid(), ts->eip, ts->esp);
+  if(kstackguard((uint)ts->esp))
+    panic("kernel stack overflow");
+  panic("double fault");
+}
 
 void
 tvinit(void)
@@ -22,6 +43,8 @@ tvinit(void)
   for(i = 0; i < 256; i++)
     SETGATE(idt[i], 0, SEG_KCODE<<3, vectors[i], 0);
   SETGATE(idt[T_SYSCALL], 1, SEG_KCODE<<3, vectors[T_SYSCALL], DPL_USER);
+  SETGATE(idt[T_DBLFLT], 0, SEG_DFTSS<<3, 0, 0);
+  idt[T_DBLFLT].type = STS_TG;
 
   initlock(&tickslock, "time");
 }
@@ -29,13 +52,69 @@ tvinit(void)
 void
 idtinit(void)
 {
+  extern char sysenter_entry[];
+  extern pde_t *kpgdir;
+  struct cpu *c;
+  struct taskstate *ts;
+  uint a, b, cx, d;
+
   lidt(idt, sizeof(idt));
+
+  c = mycpu();
+  ts = &dfts[cpuid()];
+  memset(ts, 0, sizeof(*ts));
+  ts->cr3 = (void*)V2P(kpgdir);
+  ts->eip = (uint*)dblfault;
+  ts->esp = (uint*)(dfstack[cpuid()] + PGSIZE);
+  ts->cs = SEG_KCODE << 3;
+  ts->ds = ts->es = ts->ss = SEG_KDATA << 3;
+  ts->eflags = 0x2;    // bit 1 is always set; FL_IF clear
+  ts->iomb = (ushort) 0xFFFF;
+  c->gdt[SEG_DFTSS] = SEG16(STS_T32A, ts, sizeof(*ts)-1, 0);
+  c->gdt[SEG_DFTSS].s = 0;
+
+  // sysenter loads %cs from this MSR and %ss from the next GDT
+  // entry; sysexit uses the two after that (SEG_UCODE, SEG_UDATA).
+  // switchuvm sets the stack (MSR_SYSENTER_ESP). Early Pentium
+  // Pros report SEP without supporting it.
+  readcpuid(1, &a, &b, &cx, &d);
+  havesep = (d & CPUID_SEP) &&
+            !((a & 0xf00) == 0x600 && (a & 0xf0) < 0x30 && (a & 0xf) < 3);
+  if(!havesep)
+    return;
+  wrmsr(MSR_SYSENTER_CS, SEG_KCODE<<3);
+  wrmsr(MSR_SYSENTER_EIP, (uint)sysenter_entry);
+}
+
+// System calls made with sysenter (see trapasm.S). Same as the
+// T_SYSCALL case of trap(), without going through its dispatch.
+void
+fastsyscall(struct trapframe *tf)
+{
+  if(myproc()->killed)
+    exit();
+  myproc()->tf = tf;
+  syscall();
+  if(myproc()->killed)
+    exit();
 }
 
 //PAGEBREAK: 41
 void
 trap(struct trapframe *tf)
 {
+  extern char sysenter_entry[];
+
+  // Without sysenter, usys.S's sysenter is an illegal instruction:
+  // run the call as int $T_SYSCALL would, returning where sysexit
+  // would have (%edx, with the stack in %ecx).
+  if(tf->trapno == T_ILLOP && !havesep && (tf->cs&3) == DPL_USER &&
+     tf->eip + 2 <= myproc()->sz && *(ushort*)tf->eip == 0x340f){
+    tf->eip = tf->edx;
+    tf->esp = tf->ecx;
+    tf->trapno = T_SYSCALL;
+  }
+
   if(tf->trapno == T_SYSCALL){
     if(myproc()->killed)
       exit();
@@ -51,6 +130,7 @@ trap(struct trapframe *tf)
     if(cpuid() == 0){
       acquire(&tickslock);
       ticks++;
+      sysinfotick();
       wakeup(&ticks);
       release(&tickslock);
     }
@@ -77,11 +157,23 @@ trap(struct trapframe *tf)
             cpuid(), tf->cs, tf->eip);
     lapiceoi();
     break;
+  case T_DEBUG:
+    // sysenter does not clear TF, so a user that sets it takes a
+    // single-step trap on the first instruction of sysenter_entry.
+    // Clear TF there and let the system call go on; the user loses
+    // single stepping, since sysexit does not restore eflags.
+    if((tf->cs&3) == 0 && tf->eip == (uint)sysenter_entry){
+      tf->eflags &= ~FL_TF;
+      break;
+    }
+    // fall through
 
   //PAGEBREAK: 13
   default:
     if(myproc() == 0 || (tf->cs&3) == 0){
       // In kernel, it must be our mistake.
+      if(tf->trapno == T_PGFLT && kstackguard(rcr2()))
+        panic("kernel stack overflow");
       cprintf("unexpected trap %d from cpu %d eip %x (cr2=0x%x)\n",
               tf->trapno, cpuid(), tf->eip, rcr2());
       panic("trap");
@@ -107,7 +199,7 @@ trap(struct trapframe *tf)
   //
   // COLA ALTA (priority = 0):
   //   - Procesos nuevos o interactivos (I/O bound)
-  //   - Quantum de tiempo: 5 ticks (~50ms)
+  //   - Quantum de tiempo: 5 ticks (~50ms), hasta 10 con nice negativo
   //   - Si un proceso usa todo su quantum, se degrada a cola baja
   //
   // COLA BAJA (priority = 1):
@@ -121,14 +213,23 @@ trap(struct trapframe *tf)
   if(myproc() && myproc()->state == RUNNING &&
      tf->trapno == T_IRQ0+IRQ_TIMER){
     
+    // Los procesos de tiempo real (EDF) no usan las colas: el tick se
+    // descuenta de su presupuesto del período (ver rtset en proc.c)
+    if(myproc()->rtperiod)
+      myproc()->rtused++;
+
     // Incrementar el contador de ticks usados por el proceso actual
     // Cada tick representa aproximadamente 10ms de tiempo de CPU
     myproc()->ticks_used++;
     
     // Verificar si el proceso debe ser degradado de prioridad:
     // - ¿Está en la cola de alta prioridad? (priority == 0)
-    // - ¿Ha consumido su quantum completo? (ticks_used >= 5)
-    if(myproc()->priority == 0 && myproc()->ticks_used >= 5){
+    // - ¿Ha consumido su quantum completo? (5 ticks, más o menos según
+    //   su nice: 5 - nice/4)
+    // - ¿No está en cola alta prestada por un sleeplock? (boost == 0)
+    if(myproc()->priority == 0 &&
+       myproc()->ticks_used >= 5 - myproc()->nice / 4 &&
+       myproc()->boost == 0){
       // DEGRADACIÓN: Mover el proceso a la cola de baja prioridad
       // Esto indica que el proceso es CPU-intensive y no debe bloquear
       // a procesos más interactivos
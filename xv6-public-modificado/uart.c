@@ -1,4 +1,9 @@
 // Intel 8250 serial port (UART).
+//
+// Output is interrupt-driven: uartputc() appends to a transmit ring
+// and returns; the THRE (transmitter holding register empty) interrupt
+// moves bytes from the ring to the chip. Only when the ring is full
+// does uartputc() wait for the hardware.
 
 #include "types.h"
 #include "defs.h"
@@ -14,15 +19,33 @@
 
 #define COM1    0x3f8
 
+#define UART_TX_BUF 2048   // transmit ring size (power of 2)
+
 static int uart;    // is there a uart?
 
+static struct {
+  struct spinlock lock;
+  char buf[UART_TX_BUF];
+  uint r;           // next byte to send to the chip
+  uint w;           // next free slot
+  int fifo;         // bytes the chip accepts per THRE (16 on a 16550A)
+  int sync;         // panic: write directly, skip the ring and the lock
+} tx;
+
+static void uartstart(void);
+
 void
 uartinit(void)
 {
   char *p;
 
-  // Turn off the FIFO
-  outb(COM1+2, 0);
+  initlock(&tx.lock, "uart");
+
+  // Turn on and clear the FIFOs; a 16550A reports them in IIR bits 6-7.
+  outb(COM1+2, 0x07);
+  tx.fifo = (inb(COM1+2) & 0xC0) == 0xC0 ? 16 : 1;
+  if(tx.fifo == 1)
+    outb(COM1+2, 0);
 
   // 9600 baud, 8 data bits, 1 stop bit, parity off.
   outb(COM1+3, 0x80);    // Unlock divisor
@@ -30,7 +53,7 @@ uartinit(void)
   outb(COM1+1, 0);
   outb(COM1+3, 0x03);    // Lock divisor, 8 data bits.
   outb(COM1+4, 0);
-  outb(COM1+1, 0x01);    // Enable receive interrupts.
+  outb(COM1+1, 0x03);    // Enable receive and transmit-empty interrupts.
 
   // If status is 0xFF, no serial port.
   if(inb(COM1+5) == 0xFF)
@@ -48,18 +71,65 @@ uartinit(void)
     uartputc(*p);
 }
 
-void
-uartputc(int c)
+// Busy-wait until the chip can take a byte, then send it.
+static void
+uartputc_sync(int c)
 {
   int i;
 
-  if(!uart)
-    return;
   for(i = 0; i < 128 && !(inb(COM1+5) & 0x20); i++)
     microdelay(10);
   outb(COM1+0, c);
 }
 
+// Move bytes from the ring to the chip while it has room.
+// Caller holds tx.lock.
+static void
+uartstart(void)
+{
+  int n;
+
+  if(tx.r == tx.w || !(inb(COM1+5) & 0x20))
+    return;
+  // THR (and FIFO, if any) is empty: fill it.
+  for(n = 0; n < tx.fifo && tx.r != tx.w; n++)
+    outb(COM1+0, tx.buf[tx.r++ % UART_TX_BUF]);
+}
+
+void
+uartputc(int c)
+{
+  if(!uart)
+    return;
+  if(tx.sync){
+    uartputc_sync(c);
+    return;
+  }
+
+  acquire(&tx.lock);
+  if(tx.w - tx.r == UART_TX_BUF){
+    // Ring full: make room by waiting for the chip.
+    // Interrupts are off here, so the THRE interrupt cannot do it.
+    uartputc_sync(tx.buf[tx.r++ % UART_TX_BUF]);
+  }
+  tx.buf[tx.w++ % UART_TX_BUF] = c;
+  uartstart();
+  release(&tx.lock);
+}
+
+// Drain the ring by polling and write synchronously from now on.
+// Called by panic() with interrupts off; does not take tx.lock
+// because the panicking code may already hold it.
+void
+uartsync(void)
+{
+  if(!uart)
+    return;
+  tx.sync = 1;
+  while(tx.r != tx.w)
+    uartputc_sync(tx.buf[tx.r++ % UART_TX_BUF]);
+}
+
 static int
 uartgetc(void)
 {
@@ -73,5 +143,12 @@ uartgetc(void)
 void
 uartintr(void)
 {
+  // Reading IIR acknowledges a pending THRE interrupt.
+  inb(COM1+2);
+
+  acquire(&tx.lock);
+  uartstart();
+  release(&tx.lock);
+
   consoleintr(uartgetc);
 }
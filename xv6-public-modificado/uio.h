@@ -0,0 +1,28 @@
+// Vectored and batched I/O (readv, writev, batch).
+
+#define UIO_MAXIOV 16   // most iovecs per readv/writev
+#define BATCHMAX   64   // most operations per batch
+
+struct iovec {
+  void *base;
+  int len;
+};
+
+// batch() operations. A negative fd means the fd returned by
+// the most recent BOP_OPEN in the same batch.
+#define BOP_OPEN   1   // path, n = open mode     -> fd
+#define BOP_CLOSE  2   // fd                      -> 0
+#define BOP_READ   3   // fd, buf, n              -> bytes read
+#define BOP_WRITE  4   // fd, buf, n              -> bytes written
+#define BOP_MKDIR  5   // path                    -> 0
+#define BOP_UNLINK 6   // path                    -> 0
+#define BOP_FSTAT  7   // fd, buf = struct stat*  -> 0
+
+struct batchop {
+  int op;
+  int fd;
+  char *path;
+  void *buf;
+  int n;
+  int ret;       // result, filled in by the kernel
+};
@@ -3,6 +3,8 @@
 #include "fcntl.h"
 #include "user.h"
 #include "x86.h"
+#include "uio.h"
+#include "sysinfo.h"
 
 char*
 strcpy(char *s, const char *t)
@@ -36,7 +38,20 @@ strlen(const char *s)
 void*
 memset(void *dst, int c, uint n)
 {
-  stosb(dst, c, n);
+  char *d;
+  uint k;
+
+  // Same fast paths as the kernel's string.c.
+  d = dst;
+  c &= 0xFF;
+  if(n >= 16){
+    k = -(uint)d % 4;
+    stosb(d, c, k);
+    stosl(d + k, (c<<24)|(c<<16)|(c<<8)|c, (n - k)/4);
+    d += k + ((n - k) & ~3);
+    n = (n - k) % 4;
+  }
+  stosb(d, c, n);
   return dst;
 }
 
@@ -67,18 +82,26 @@ gets(char *buf, int max)
   return buf;
 }
 
+// open, fstat and close in a single system call.
 int
 stat(const char *n, struct stat *st)
 {
-  int fd;
+  struct batchop ops[3];
   int r;
 
-  fd = open(n, O_RDONLY);
-  if(fd < 0)
-    return -1;
-  r = fstat(fd, st);
-  close(fd);
-  return r;
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = BOP_OPEN;
+  ops[0].path = (char*)n;
+  ops[0].n = O_RDONLY;
+  ops[1].op = BOP_FSTAT;
+  ops[1].fd = -1;
+  ops[1].buf = st;
+  ops[2].op = BOP_CLOSE;
+  ops[2].fd = -1;
+  r = batch(ops, 3);
+  if(r == 1)
+    close(ops[0].ret);   // fstat failed
+  return r == 3 ? 0 : -1;
 }
 
 int
@@ -97,10 +120,92 @@ memmove(void *vdst, const void *vsrc, int n)
 {
   char *dst;
   const char *src;
+  int k;
 
+  if(n <= 0)
+    return vdst;
   dst = vdst;
   src = vsrc;
-  while(n-- > 0)
-    *dst++ = *src++;
+  if(src < dst && src + n > dst){
+    src += n;
+    dst += n;
+    if(n >= 16){
+      for(k = (uint)dst % 4; k > 0; k--, n--)
+        *--dst = *--src;
+      k = n / 4;
+      movsl_back(dst - 4, src - 4, k);
+      dst -= k * 4;
+      src -= k * 4;
+      n %= 4;
+    }
+    while(n-- > 0)
+      *--dst = *--src;
+    return vdst;
+  }
+
+  if(n >= 16){
+    k = -(uint)dst % 4;
+    movsb(dst, src, k);
+    movsl(dst + k, src + k, (n - k)/4);
+    k += (n - k) & ~3;
+    dst += k;
+    src += k;
+    n -= k;
+  }
+  movsb(dst, src, n);
   return vdst;
 }
+
+int
+memcmp(const void *v1, const void *v2, uint n)
+{
+  const uchar *s1, *s2;
+
+  s1 = v1;
+  s2 = v2;
+  while(n >= 4 && *(uint*)s1 == *(uint*)s2){
+    s1 += 4, s2 += 4;
+    n -= 4;
+  }
+  while(n-- > 0){
+    if(*s1 != *s2)
+      return *s1 - *s2;
+    s1++, s2++;
+  }
+  return 0;
+}
+
+// Time and pid from the pages the kernel maps at USYSINFO
+// (see sysinfo.h), without a system call.
+
+// Timer ticks since boot, like uptime().
+uint
+uticks(void)
+{
+  return ((struct sysinfo*)USYSINFO)->ticks;
+}
+
+// Microseconds since boot, refined between ticks with the TSC.
+uint
+utime(void)
+{
+  struct sysinfo *si = (struct sysinfo*)USYSINFO;
+  uint seq, usec, tsc, per;
+
+  do {
+    seq = si->seq;
+    usec = si->usec;
+    tsc = si->tsc;
+    per = si->tscperus;
+  } while((seq & 1) || seq != si->seq);
+  if(per == 0)
+    return usec;
+  return usec + (rdtsc() - tsc) / per;
+}
+
+// Like getpid().
+int
+upid(void)
+{
+  return ((struct procinfo*)(USYSINFO + 4096))->pid;
+}
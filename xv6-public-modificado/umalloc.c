@@ -3,88 +3,279 @@
 #include "user.h"
 #include "param.h"
 
-// Memory allocator by Kernighan and Ritchie,
-// The C programming Language, 2nd ed.  Section 8.7.
+// Memory allocator with size classes.
+//
+// The heap is managed in 4096-byte pages obtained with sbrk().
+// Small requests (up to 1024 bytes) are served from slab pages:
+// each slab holds objects of a single size class, linked on a
+// per-slab free list, so malloc and free are O(1).
+// Larger requests get a run of whole pages (a "span").
+// Free pages are kept on an address-ordered list of spans that
+// coalesce, and a large free span at the top of the heap is
+// given back to the kernel with a negative sbrk().
+//
+// Every slab and every large object starts with a header at a
+// page boundary, so free() finds it by rounding the pointer down.
 
-typedef long Align;
+#define PAGE      4096
+#define NCLASS    7           // 16, 32, ..., 1024 bytes
+#define MINCLASS  16
+#define MAXSMALL  (MINCLASS << (NCLASS-1))
+#define HDRSIZE   32          // header space at the start of a page
+#define LARGE     NCLASS      // header kind of a large object
+#define GROWPAGES 8           // minimum pages requested from sbrk
+#define TRIMPAGES 16          // return a top free span this big
 
-union header {
-  struct {
-    union header *ptr;
-    uint size;
-  } s;
-  Align x;
+struct obj {
+  struct obj *next;
 };
 
-typedef union header Header;
+struct slab {                 // at the start of a slab page
+  uint kind;                  // size class
+  uint nfree;
+  struct obj *free;
+  struct slab *next;          // on the class's partial list
+  struct slab *prev;
+};
 
-static Header base;
-static Header *freep;
+struct large {                // at the start of a large object
+  uint kind;                  // LARGE
+  uint npages;
+};
 
-void
-free(void *ap)
+struct span {                 // at the start of a free page run
+  uint npages;
+  struct span *next;
+};
+
+static struct slab *partial[NCLASS];  // slabs with free objects
+static struct slab *spare[NCLASS];    // one cached empty slab
+static struct span *spans;            // free page runs, by address
+
+static uint
+classsize(int c)
+{
+  return MINCLASS << c;
+}
+
+static uint
+classcount(int c)
+{
+  return (PAGE - HDRSIZE) / classsize(c);
+}
+
+static int
+sizeclass(uint nbytes)
+{
+  int c;
+
+  for(c = 0; classsize(c) < nbytes; c++)
+    ;
+  return c;
+}
+
+// Insert the page run [p, p+npages*PAGE) in the span list,
+// merging it with its neighbours. Returns the resulting span.
+static struct span*
+insertspan(char *p, uint npages)
+{
+  struct span *s, *prev, *n;
+
+  prev = 0;
+  for(n = spans; n && (char*)n < p; n = n->next)
+    prev = n;
+
+  s = (struct span*)p;
+  s->npages = npages;
+  s->next = n;
+  if(n && p + npages*PAGE == (char*)n){
+    s->npages += n->npages;
+    s->next = n->next;
+  }
+  if(prev && (char*)prev + prev->npages*PAGE == p){
+    prev->npages += s->npages;
+    prev->next = s->next;
+    return prev;
+  }
+  if(prev)
+    prev->next = s;
+  else
+    spans = s;
+  return s;
+}
+
+// Free pages; if that leaves a big span ending at the
+// program break, give it back to the kernel.
+static void
+freepages(char *p, uint npages)
 {
-  Header *bp, *p;
-
-  bp = (Header*)ap - 1;
-  for(p = freep; !(bp > p && bp < p->s.ptr); p = p->s.ptr)
-    if(p >= p->s.ptr && (bp > p || bp < p->s.ptr))
-      break;
-  if(bp + bp->s.size == p->s.ptr){
-    bp->s.size += p->s.ptr->s.size;
-    bp->s.ptr = p->s.ptr->s.ptr;
-  } else
-    bp->s.ptr = p->s.ptr;
-  if(p + p->s.size == bp){
-    p->s.size += bp->s.size;
-    p->s.ptr = bp->s.ptr;
-  } else
-    p->s.ptr = bp;
-  freep = p;
+  struct span *s, **pp;
+
+  s = insertspan(p, npages);
+  if(s->next != 0 || s->npages < TRIMPAGES ||
+     (char*)s + s->npages*PAGE != sbrk(0))
+    return;
+  for(pp = &spans; *pp != s; pp = &(*pp)->next)
+    ;
+  *pp = 0;
+  if(sbrk(-(int)(s->npages*PAGE)) == (char*)-1)
+    *pp = s;   // Not allowed (the process has threads): keep the span
 }
 
-static Header*
-morecore(uint nu)
+// Get npages contiguous pages: first fit on the span list,
+// otherwise grow the heap with sbrk().
+static char*
+allocpages(uint npages)
 {
+  struct span *s, **pp, *last;
+  char *p, *brk;
+  uint need, grow;
+
+  last = 0;
+  for(pp = &spans; (s = *pp) != 0; pp = &s->next){
+    if(s->npages > npages){
+      // Take the tail so the list link stays in place.
+      s->npages -= npages;
+      return (char*)s + s->npages*PAGE;
+    }
+    if(s->npages == npages){
+      *pp = s->next;
+      return (char*)s;
+    }
+    last = s;
+  }
+
+  brk = sbrk(0);
+  if((uint)brk % PAGE){
+    if(sbrk(PAGE - (uint)brk % PAGE) == (char*)-1)
+      return 0;
+    brk += PAGE - (uint)brk % PAGE;
+  }
+
+  // If the last free span ends at the break, only extend it.
+  need = npages;
+  if(last && (char*)last + last->npages*PAGE == brk)
+    need -= last->npages;
+  grow = need < GROWPAGES ? GROWPAGES : need;
+  if((p = sbrk(grow*PAGE)) == (char*)-1){
+    grow = need;
+    if((p = sbrk(grow*PAGE)) == (char*)-1)
+      return 0;
+  }
+  insertspan(p, grow);
+  return allocpages(npages);
+}
+
+static struct slab*
+newslab(int c)
+{
+  struct slab *sl;
+  struct obj *o;
   char *p;
-  Header *hp;
+  uint i, size;
 
-  if(nu < 4096)
-    nu = 4096;
-  p = sbrk(nu * sizeof(Header));
-  if(p == (char*)-1)
+  if((sl = spare[c]) != 0){
+    spare[c] = 0;
+    return sl;
+  }
+  if((p = allocpages(1)) == 0)
     return 0;
-  hp = (Header*)p;
-  hp->s.size = nu;
-  free((void*)(hp + 1));
-  return freep;
+  sl = (struct slab*)p;
+  sl->kind = c;
+  sl->nfree = classcount(c);
+  sl->free = 0;
+  size = classsize(c);
+  for(i = sl->nfree; i > 0; i--){
+    o = (struct obj*)(p + HDRSIZE + (i-1)*size);
+    o->next = sl->free;
+    sl->free = o;
+  }
+  return sl;
+}
+
+static void
+unlinkslab(struct slab *sl)
+{
+  if(sl->prev)
+    sl->prev->next = sl->next;
+  else
+    partial[sl->kind] = sl->next;
+  if(sl->next)
+    sl->next->prev = sl->prev;
+}
+
+static void
+pushslab(struct slab *sl)
+{
+  sl->prev = 0;
+  sl->next = partial[sl->kind];
+  if(sl->next)
+    sl->next->prev = sl;
+  partial[sl->kind] = sl;
+}
+
+void
+free(void *ap)
+{
+  struct slab *sl;
+  struct large *lg;
+  struct obj *o;
+  int c;
+
+  if(ap == 0)
+    return;
+  sl = (struct slab*)((uint)ap & ~(PAGE-1));
+  if(sl->kind == LARGE){
+    lg = (struct large*)sl;
+    freepages((char*)lg, lg->npages);
+    return;
+  }
+
+  c = sl->kind;
+  o = (struct obj*)ap;
+  o->next = sl->free;
+  sl->free = o;
+  if(sl->nfree++ == 0)
+    pushslab(sl);             // was full
+  if(sl->nfree == classcount(c)){
+    // Empty: keep one per class, give the rest back.
+    unlinkslab(sl);
+    if(spare[c] == 0)
+      spare[c] = sl;
+    else
+      freepages((char*)sl, 1);
+  }
 }
 
 void*
 malloc(uint nbytes)
 {
-  Header *p, *prevp;
-  uint nunits;
+  struct slab *sl;
+  struct large *lg;
+  struct obj *o;
+  uint npages;
+  int c;
 
-  nunits = (nbytes + sizeof(Header) - 1)/sizeof(Header) + 1;
-  if((prevp = freep) == 0){
-    base.s.ptr = freep = prevp = &base;
-    base.s.size = 0;
+  if(nbytes > MAXSMALL){
+    if(nbytes > 0x7fff0000)   // sbrk() takes an int
+      return 0;
+    npages = (nbytes + HDRSIZE + PAGE - 1) / PAGE;
+    if((lg = (struct large*)allocpages(npages)) == 0)
+      return 0;
+    lg->kind = LARGE;
+    lg->npages = npages;
+    return (char*)lg + HDRSIZE;
   }
-  for(p = prevp->s.ptr; ; prevp = p, p = p->s.ptr){
-    if(p->s.size >= nunits){
-      if(p->s.size == nunits)
-        prevp->s.ptr = p->s.ptr;
-      else {
-        p->s.size -= nunits;
-        p += p->s.size;
-        p->s.size = nunits;
-      }
-      freep = prevp;
-      return (void*)(p + 1);
-    }
-    if(p == freep)
-      if((p = morecore(nunits)) == 0)
-        return 0;
+
+  c = sizeclass(nbytes);
+  if((sl = partial[c]) == 0){
+    if((sl = newslab(c)) == 0)
+      return 0;
+    pushslab(sl);
   }
+  o = sl->free;
+  sl->free = o->next;
+  if(--sl->nfree == 0)
+    unlinkslab(sl);           // full
+  return (void*)o;
 }
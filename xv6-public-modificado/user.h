@@ -1,5 +1,12 @@
 struct stat;
+struct fsstat;
 struct rtcdate;
+struct iovec;
+struct batchop;
+struct clockval;
+struct lockstat;
+struct lock;
+struct cond;
 
 // system calls
 int fork(void);
@@ -23,6 +30,25 @@ int getpid(void);
 char* sbrk(int);
 int sleep(int);
 int uptime(void);
+int fsstat(struct fsstat*);
+int getsyscount(void);
+int getcswitch(void);
+int sendfile(int, int, int);
+int readv(int, struct iovec*, int);
+int writev(int, struct iovec*, int);
+int batch(struct batchop*, int);
+int clock(struct clockval*);
+int lockstat(struct lockstat*, int, int);
+int clone(void(*)(void*), void*, void*);
+int join(void**);
+int futex(volatile uint*, int, int);
+int kstackuse(int);
+int rtset(int, int, int);
+int rtwait(void);
+int getpriority(int);
+int setpriority(int, int);
+int getpid_int(void);   // through int $T_SYSCALL
+int uptime_int(void);
 
 // ulib.c
 int stat(const char*, struct stat*);
@@ -31,9 +57,25 @@ void *memmove(void*, const void*, int);
 char* strchr(const char*, char c);
 int strcmp(const char*, const char*);
 void printf(int, const char*, ...);
+int snprintf(char*, int, const char*, ...);
 char* gets(char*, int max);
 uint strlen(const char*);
 void* memset(void*, int, uint);
+int memcmp(const void*, const void*, uint);
 void* malloc(uint);
 void free(void*);
 int atoi(const char*);
+uint uticks(void);
+uint utime(void);
+int upid(void);
+
+// uthread.c
+int thread_create(void(*)(void*), void*);
+int thread_join(void);
+void lock_init(struct lock*);
+void lock_acquire(struct lock*);
+void lock_release(struct lock*);
+void cond_init(struct cond*);
+void cond_wait(struct cond*, struct lock*);
+void cond_signal(struct cond*);
+void cond_broadcast(struct cond*);
@@ -1373,9 +1373,8 @@ iref(void)
   printf(1, "empty file name OK\n");
 }
 
-// test that fork fails gracefully
-// the forktest binary also does this, but it runs out of proc entries first.
-// inside the bigger usertests binary, we run out of memory first.
+// test that fork fails gracefully by running out of memory.
+// the forktest binary also does this.
 void
 forktest(void)
 {
@@ -1383,7 +1382,7 @@ forktest(void)
 
   printf(1, "fork test\n");
 
-  for(n=0; n<1000; n++){
+  for(n=0; n<10000; n++){
     pid = fork();
     if(pid < 0)
       break;
@@ -1391,8 +1390,8 @@ forktest(void)
       exit();
   }
 
-  if(n == 1000){
-    printf(1, "fork claimed to work 1000 times!\n");
+  if(n == 10000){
+    printf(1, "fork claimed to work 10000 times!\n");
     exit();
   }
 
@@ -0,0 +1,142 @@
+#include "types.h"
+#include "user.h"
+#include "x86.h"
+#include "uthread.h"
+#include "futex.h"
+
+// Threads share the caller's memory. Each runs on a one-page
+// stack from malloc(); its first bytes hold the function to
+// call, since clone() passes a single argument.
+
+#define STACKSIZE 4096
+#define LOCKSPIN  100       // tries before sleeping in lock_acquire()
+
+struct start {
+  void (*fn)(void*);
+  void *arg;
+};
+
+// malloc() and free() are not thread-safe.
+static struct lock stacklock;
+
+static void
+threadstart(void *v)
+{
+  struct start *st = v;
+
+  st->fn(st->arg);
+  exit();
+}
+
+// Run fn(arg) in a new thread. Return its pid, or -1.
+int
+thread_create(void (*fn)(void*), void *arg)
+{
+  struct start *st;
+  int pid;
+
+  lock_acquire(&stacklock);
+  st = malloc(STACKSIZE);
+  lock_release(&stacklock);
+  if(st == 0)
+    return -1;
+  st->fn = fn;
+  st->arg = arg;
+  if((pid = clone(threadstart, st, st)) < 0){
+    lock_acquire(&stacklock);
+    free(st);
+    lock_release(&stacklock);
+  }
+  return pid;
+}
+
+// Wait for a thread to exit and free its stack.
+// Return its pid, or -1 if there are no other threads.
+int
+thread_join(void)
+{
+  void *stack;
+  int pid;
+
+  if((pid = join(&stack)) < 0)
+    return -1;
+  lock_acquire(&stacklock);
+  free(stack);
+  lock_release(&stacklock);
+  return pid;
+}
+
+void
+lock_init(struct lock *lk)
+{
+  lk->locked = 0;
+}
+
+// Take the lock, sleeping in futex() while it is held.
+// A sleeper marks the lock 2 so that the holder knows to
+// wake someone; after waking it takes the lock as 2 too,
+// since other sleepers may remain.
+void
+lock_acquire(struct lock *lk)
+{
+  uint c;
+  int i;
+
+  if((c = cmpxchg(&lk->locked, 0, 1)) == 0)
+    return;
+  // Holders run briefly: spin a little before sleeping.
+  for(i = 0; i < LOCKSPIN && c == 1; i++){
+    pause();
+    if((c = cmpxchg(&lk->locked, 0, 1)) == 0)
+      return;
+  }
+  if(c != 2)
+    c = xchg(&lk->locked, 2);
+  while(c != 0){
+    futex(&lk->locked, FUTEX_WAIT, 2);
+    c = xchg(&lk->locked, 2);
+  }
+}
+
+void
+lock_release(struct lock *lk)
+{
+  if(xchg(&lk->locked, 0) == 2)
+    futex(&lk->locked, FUTEX_WAKE, 1);
+}
+
+void
+cond_init(struct cond *cv)
+{
+  cv->seq = 0;
+}
+
+// Release lk, sleep until signaled, and take lk again.
+// As with any condition variable, the caller rechecks its
+// condition in a loop.
+void
+cond_wait(struct cond *cv, struct lock *lk)
+{
+  uint seq;
+
+  seq = cv->seq;
+  lock_release(lk);
+  futex(&cv->seq, FUTEX_WAIT, seq);
+  // Others may be waiting for lk too.
+  while(xchg(&lk->locked, 2) != 0)
+    futex(&lk->locked, FUTEX_WAIT, 2);
+}
+
+void
+cond_signal(struct cond *cv)
+{
+  xadd(&cv->seq, 1);
+  futex(&cv->seq, FUTEX_WAKE, 1);
+}
+
+void
+cond_broadcast(struct cond *cv)
+{
+  xadd(&cv->seq, 1);
+  futex(&cv->seq, FUTEX_WAKE, 0x7fffffff);
+}
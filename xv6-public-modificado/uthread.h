@@ -0,0 +1,12 @@
+// User-level threads: thread_create() and thread_join() on
+// top of the clone() and join() system calls, and a lock and
+// condition variable for data the threads share. Both sleep
+// in futex() instead of spinning.
+
+struct lock {
+  volatile uint locked;   // 0 free, 1 held, 2 held with waiters
+};
+
+struct cond {
+  volatile uint seq;      // bumped by every signal
+};
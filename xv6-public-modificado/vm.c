@@ -5,7 +5,9 @@
 #include "memlayout.h"
 #include "mmu.h"
 #include "proc.h"
+#include "spinlock.h"
 #include "elf.h"
+#include "sysinfo.h"
 
 extern char data[];  // defined by kernel.ld
 pde_t *kpgdir;  // for use in scheduler()
@@ -42,10 +44,9 @@ walkpgdir(pde_t *pgdir, const void *va, int alloc)
   if(*pde & PTE_P){
     pgtab = (pte_t*)P2V(PTE_ADDR(*pde));
   } else {
-    if(!alloc || (pgtab = (pte_t*)kalloc()) == 0)
+    // kzalloc: make sure all those PTE_P bits are zero.
+    if(!alloc || (pgtab = (pte_t*)kzalloc()) == 0)
       return 0;
-    // Make sure all those PTE_P bits are zero.
-    memset(pgtab, 0, PGSIZE);
     // The permissions here are overly generous, but they can
     // be further restricted by the permissions in the page table
     // entries, if necessary.
@@ -79,6 +80,102 @@ mappages(pde_t *pgdir, void *va, uint size, uint pa, int perm)
   return 0;
 }
 
+// Kernel stacks live at KSTACKS, outside the direct map. Each one
+// is KSTACKSIZE bytes of pages mapped above an unmapped guard page,
+// so running off the end faults (see trap.c) instead of writing over
+// whatever page came next. The region's page tables are made with
+// kpgdir and shared by every pgdir, so mapping a stack allocates
+// nothing and is seen in all address spaces.
+//
+// Freed slots are reused without a TLB shootdown. Another CPU only
+// uses a process's stack after switchuvm() reloads %cr3, dropping
+// any stale entry; the CPU that maps a stack writes to it right away,
+// so it flushes its own entries.
+#define KSTACKSLOT (PGSIZE + KSTACKSIZE)
+#define KSTACKTOP  (KSTACKS + NKSTACK*KSTACKSLOT)
+#define KSTACKFILL 0x6b   // never-used stack bytes, for kstackused()
+
+struct {
+  struct spinlock lock;
+  int top;                // slots >= top were never used
+  int nfree;
+  ushort free[NKSTACK];   // freed slots, reused last-in first-out
+} kstacks;
+
+// Allocate a kernel stack. Returns its lowest address, or 0.
+char*
+kstackalloc(void)
+{
+  char *kstack, *mem;
+  pte_t *pte;
+  uint a;
+  int slot;
+
+  acquire(&kstacks.lock);
+  slot = -1;
+  if(kstacks.nfree > 0)
+    slot = kstacks.free[--kstacks.nfree];
+  else if(kstacks.top < NKSTACK)
+    slot = kstacks.top++;
+  release(&kstacks.lock);
+  if(slot < 0)
+    return 0;
+
+  kstack = (char*)KSTACKS + slot*KSTACKSLOT + PGSIZE;
+  for(a = 0; a < KSTACKSIZE; a += PGSIZE){
+    if((mem = kalloc()) == 0){
+      kstackfree(kstack);
+      return 0;
+    }
+    pte = walkpgdir(kpgdir, kstack + a, 0);
+    *pte = V2P(mem) | PTE_W | PTE_P;
+    invlpg(kstack + a);
+  }
+  memset(kstack, KSTACKFILL, KSTACKSIZE);
+  return kstack;
+}
+
+// Unmap and free a kernel stack. Pages that were never
+// mapped (a failed kstackalloc) are skipped.
+void
+kstackfree(char *kstack)
+{
+  pte_t *pte;
+  uint a;
+
+  for(a = 0; a < KSTACKSIZE; a += PGSIZE){
+    pte = walkpgdir(kpgdir, kstack + a, 0);
+    if(*pte & PTE_P){
+      kfree(P2V(PTE_ADDR(*pte)));
+      *pte = 0;
+    }
+  }
+  acquire(&kstacks.lock);
+  kstacks.free[kstacks.nfree++] = ((uint)kstack - KSTACKS) / KSTACKSLOT;
+  release(&kstacks.lock);
+}
+
+// High-water mark of a kernel stack in bytes. The stack grows
+// down, so count the words at the bottom that still hold the fill.
+int
+kstackused(char *kstack)
+{
+  uint *w;
+
+  for(w = (uint*)kstack; w < (uint*)(kstack + KSTACKSIZE); w++)
+    if(*w != KSTACKFILL * 0x01010101)
+      break;
+  return kstack + KSTACKSIZE - (char*)w;
+}
+
+// Is va in the guard page below some kernel stack?
+int
+kstackguard(uint va)
+{
+  return va >= KSTACKS && va < KSTACKTOP &&
+         (va - KSTACKS) % KSTACKSLOT < PGSIZE;
+}
+
 // There is one page table per process, plus one that's used when
 // a CPU is not running any process (kpgdir). The kernel uses the
 // current process's page table during system calls and interrupts;
@@ -87,13 +184,15 @@ mappages(pde_t *pgdir, void *va, uint size, uint pa, int perm)
 //
 // setupkvm() and exec() set up every page table like this:
 //
-//   0..KERNBASE: user memory (text+data+stack+heap), mapped to
+//   0..USYSINFO: user memory (text+data+stack+heap), mapped to
 //                phys memory allocated by the kernel
+//   USYSINFO..KERNBASE: read-only sysinfo and procinfo pages
 //   KERNBASE..KERNBASE+EXTMEM: mapped to 0..EXTMEM (for I/O space)
 //   KERNBASE+EXTMEM..data: mapped to EXTMEM..V2P(data)
 //                for the kernel's instructions and r/o data
 //   data..KERNBASE+PHYSTOP: mapped to V2P(data)..PHYSTOP,
 //                                  rw data + free physical memory
+//   KSTACKS..: kernel stacks and their guard pages
 //   0xfe000000..0: mapped direct (devices such as ioapic)
 //
 // The kernel allocates physical memory for its heap and for user memory
@@ -115,16 +214,24 @@ static struct kmap {
 };
 
 // Set up kernel part of a page table.
+// The kernel mappings never change after boot, so every page
+// table after kpgdir shares kpgdir's kernel page-table pages
+// instead of building ~60 of its own.
 pde_t*
 setupkvm(void)
 {
   pde_t *pgdir;
   struct kmap *k;
+  uint a;
 
-  if((pgdir = (pde_t*)kalloc()) == 0)
+  if((pgdir = (pde_t*)kzalloc()) == 0)
     return 0;
-  memset(pgdir, 0, PGSIZE);
-  if (P2V(PHYSTOP) > (void*)DEVSPACE)
+  if(kpgdir){
+    memmove(&pgdir[PDX(KERNBASE)], &kpgdir[PDX(KERNBASE)],
+            (NPDENTRIES - PDX(KERNBASE)) * sizeof(pde_t));
+    return pgdir;
+  }
+  if (KSTACKTOP > DEVSPACE)
     panic("PHYSTOP too high");
   for(k = kmap; k < &kmap[NELEM(kmap)]; k++)
     if(mappages(pgdir, k->virt, k->phys_end - k->phys_start,
@@ -132,6 +239,12 @@ setupkvm(void)
       freevm(pgdir);
       return 0;
     }
+  // Page tables for the kernel stacks, so every pgdir shares them.
+  for(a = KSTACKS; a < KSTACKTOP; a += PGSIZE*NPTENTRIES)
+    if(walkpgdir(pgdir, (void*)a, 1) == 0){
+      freevm(pgdir);
+      return 0;
+    }
   return pgdir;
 }
 
@@ -142,6 +255,7 @@ kvmalloc(void)
 {
   kpgdir = setupkvm();
   switchkvm();
+  initlock(&kstacks.lock, "kstacks");
 }
 
 // Switch h/w page table register to the kernel-only page table,
@@ -169,6 +283,7 @@ switchuvm(struct proc *p)
   mycpu()->gdt[SEG_TSS].s = 0;
   mycpu()->ts.ss0 = SEG_KDATA << 3;
   mycpu()->ts.esp0 = (uint)p->kstack + KSTACKSIZE;
+  wrmsr(MSR_SYSENTER_ESP, (uint)p->kstack + KSTACKSIZE);
   // setting IOPL=0 in eflags *and* iomb beyond the tss segment limit
   // forbids I/O instructions (e.g., inb and outb) from user space
   mycpu()->ts.iomb = (ushort) 0xFFFF;
@@ -224,20 +339,19 @@ allocuvm(pde_t *pgdir, uint oldsz, uint newsz)
   char *mem;
   uint a;
 
-  if(newsz >= KERNBASE)
+  if(newsz > USYSINFO)
     return 0;
   if(newsz < oldsz)
     return oldsz;
 
   a = PGROUNDUP(oldsz);
   for(; a < newsz; a += PGSIZE){
-    mem = kalloc();
+    mem = kzalloc();
     if(mem == 0){
       cprintf("allocuvm out of memory\n");
       deallocuvm(pgdir, newsz, oldsz);
       return 0;
     }
-    memset(mem, 0, PGSIZE);
     if(mappages(pgdir, (char*)a, PGSIZE, V2P(mem), PTE_W|PTE_U) < 0){
       cprintf("allocuvm out of memory (2)\n");
       deallocuvm(pgdir, newsz, oldsz);
@@ -279,7 +393,7 @@ deallocuvm(pde_t *pgdir, uint oldsz, uint newsz)
 }
 
 // Free a page table and all the physical memory pages
-// in the user part.
+// in the user part. The kernel part is shared (see setupkvm).
 void
 freevm(pde_t *pgdir)
 {
@@ -287,8 +401,8 @@ freevm(pde_t *pgdir)
 
   if(pgdir == 0)
     panic("freevm: no pgdir");
-  deallocuvm(pgdir, KERNBASE, 0);
-  for(i = 0; i < NPDENTRIES; i++){
+  deallocuvm(pgdir, USYSINFO, 0);  // leave the info pages alone
+  for(i = 0; i < PDX(KERNBASE); i++){
     if(pgdir[i] & PTE_P){
       char * v = P2V(PTE_ADDR(pgdir[i]));
       kfree(v);
@@ -385,6 +499,16 @@ copyout(pde_t *pgdir, uint va, void *p, uint len)
   return 0;
 }
 
+// Map the shared sysinfo page and the process's procinfo page
+// read-only for user code at USYSINFO (see sysinfo.h).
+int
+mapsysinfo(pde_t *pgdir, char *procinfo)
+{
+  if(mappages(pgdir, (char*)USYSINFO, PGSIZE, V2P(sysinfo), PTE_U) < 0)
+    return -1;
+  return mappages(pgdir, (char*)USYSINFO+PGSIZE, PGSIZE, V2P(procinfo), PTE_U);
+}
+
 //PAGEBREAK!
 // Blank page.
 //PAGEBREAK!
@@ -0,0 +1,164 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE FAN-OUT DE FORK/WAIT EN XV6
+// ============================================================================
+// Este programa mide cuánto cuesta crear y recoger muchos hijos. Antes
+// wait() recorría todos los procesos del sistema buscando los de
+// p->parent == curproc, y exit() los recorría todos para pasar los hijos
+// a init. Ahora cada proceso tiene su lista de hijos, así que el costo
+// depende de cuántos hijos tiene, no de cuántos procesos hay.
+//
+// FASES:
+// 1. ROUNDS rondas de fan-out: crear N hijos que terminan enseguida y
+//    recogerlos con wait()
+// 2. Lo mismo con B procesos ajenos vivos (bloqueados en un pipe). Sin
+//    listas de hijos cada wait() los recorría también
+// 3. Un hijo crea N nietos y termina sin esperarlos: exit() se los pasa
+//    a init
+//
+// MÉTRICAS:
+// - Microsegundos por fork y por wait (clock())
+// - Tiempo del exit() que pasa N hijos a init
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ waittest [N] [B]
+// 2. Por defecto N = 500 hijos y B = 1000 procesos ajenos
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+#include "sysinfo.h"
+
+#define DEFAULT_CHILDREN 500
+#define DEFAULT_BYSTANDERS 1000
+#define ROUNDS 3
+
+int
+now_us(void)
+{
+  struct clockval cv;
+
+  clock(&cv);
+  return cv.sec * 1000000 + cv.nsec / 1000;
+}
+
+// Crea n hijos que terminan enseguida y los recoge. Hace exactamente un
+// wait() por hijo: en la fase 2 el creador de los ajenos también es hijo
+// nuestro y no termina hasta el final.
+void
+fanout(char *label, int n)
+{
+  int i, pid, forked, reaped, t0, t1, t2;
+
+  forked = 0;
+  t0 = now_us();
+  for(i = 0; i < n; i++){
+    pid = fork();
+    if(pid < 0)
+      break;
+    if(pid == 0)
+      exit();
+    forked++;
+  }
+  t1 = now_us();
+  reaped = 0;
+  while(reaped < forked && wait() >= 0)
+    reaped++;
+  t2 = now_us();
+
+  printf(1, "%s: %d hijos, fork %d us c/u, wait %d us c/u\n", label,
+         forked, forked ? (t1 - t0) / forked : 0,
+         reaped ? (t2 - t1) / reaped : 0);
+  if(reaped != forked)
+    printf(1, "[ERROR] creados %d, recogidos %d\n", forked, reaped);
+}
+
+int
+main(int argc, char *argv[])
+{
+  int n, b, i, r, pid, keeper, fds[2], start;
+  char c;
+
+  n = DEFAULT_CHILDREN;
+  b = DEFAULT_BYSTANDERS;
+  if(argc > 1)
+    n = atoi(argv[1]);
+  if(argc > 2)
+    b = atoi(argv[2]);
+  if(n <= 0 || b < 0){
+    printf(1, "uso: waittest [N] [B]\n");
+    exit();
+  }
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE FAN-OUT FORK/WAIT - xv6\n");
+  printf(1, "========================================\n");
+  printf(1, "Hijos por ronda: %d, procesos ajenos: %d\n\n", n, b);
+
+  // FASE 1: Sin otros procesos
+  for(r = 0; r < ROUNDS; r++)
+    fanout("Solo", n);
+
+  // FASE 2: Con B procesos ajenos. Los crea un proceso aparte para que
+  // no sean hijos nuestros; se bloquean hasta que cerramos el pipe.
+  if(pipe(fds) < 0){
+    printf(1, "[ERROR] pipe fallo\n");
+    exit();
+  }
+  keeper = fork();
+  if(keeper == 0){
+    close(fds[1]);
+    for(i = 0; i < b; i++){
+      pid = fork();
+      if(pid < 0)
+        break;
+      if(pid == 0){
+        read(fds[0], &c, 1);
+        exit();
+      }
+    }
+    read(fds[0], &c, 1);
+    while(wait() >= 0)
+      ;
+    exit();
+  }
+  close(fds[0]);
+  sleep(10);   // Darle tiempo a crear a los ajenos
+  for(r = 0; r < ROUNDS; r++)
+    fanout("Con ajenos", n);
+  close(fds[1]);
+  wait();
+
+  // FASE 3: Un hijo deja N nietos huérfanos; init los recoge.
+  // El hijo avisa por el pipe cuando terminó de crearlos, para que
+  // el tiempo medido sea solo el de su exit() y nuestro wait().
+  if(pipe(fds) < 0){
+    printf(1, "[ERROR] pipe fallo\n");
+    exit();
+  }
+  pid = fork();
+  if(pid == 0){
+    close(fds[0]);
+    for(i = 0; i < n; i++){
+      r = fork();
+      if(r < 0)
+        break;
+      if(r == 0){
+        sleep(10);
+        exit();
+      }
+    }
+    printf(1, "Huerfanos: %d nietos pasan a init\n", i);
+    write(fds[1], "x", 1);
+    exit();
+  }
+  close(fds[1]);
+  read(fds[0], &c, 1);
+  start = now_us();
+  wait();
+  printf(1, "  exit() + wait() del padre: %d us\n", now_us() - start);
+  close(fds[0]);
+  printf(1, "========================================\n");
+  exit();
+}
@@ -0,0 +1,72 @@
+// Work queue: run functions later in a kernel thread.
+//
+// Code that must not wait (interrupt handlers, paths that hold
+// spinlocks) or that should not make a process wait can hand
+// the work to the kworker thread with workqueue(). The caller
+// owns the struct work; it may be queued again once its
+// function has started.
+
+#include "types.h"
+#include "defs.h"
+#include "param.h"
+#include "memlayout.h"
+#include "mmu.h"
+#include "proc.h"
+#include "spinlock.h"
+#include "workq.h"
+
+struct {
+  struct spinlock lock;
+  struct work *head;
+  struct work *tail;
+} workq;
+
+static void
+worker(void *arg)
+{
+  struct work *w;
+
+  acquire(&workq.lock);
+  for(;;){
+    while(workq.head == 0)
+      sleep(&workq, &workq.lock);
+    w = workq.head;
+    workq.head = w->next;
+    if(workq.head == 0)
+      workq.tail = 0;
+    w->pending = 0;
+    release(&workq.lock);
+    w->fn(w->arg);
+    acquire(&workq.lock);
+  }
+}
+
+void
+workinit(void)
+{
+  initlock(&workq.lock, "workq");
+  kthread("kworker", worker, 0);
+}
+
+// Queue w to run in the kworker thread. Return 0 if w was
+// already waiting to run, 1 otherwise. Safe to call from
+// interrupt handlers.
+int
+workqueue(struct work *w)
+{
+  acquire(&workq.lock);
+  if(w->pending){
+    release(&workq.lock);
+    return 0;
+  }
+  w->pending = 1;
+  w->next = 0;
+  if(workq.tail)
+    workq.tail->next = w;
+  else
+    workq.head = w;
+  workq.tail = w;
+  wakeup(&workq);
+  release(&workq.lock);
+  return 1;
+}
@@ -0,0 +1,7 @@
+// A function call deferred to the kworker thread (workq.c).
+struct work {
+  void (*fn)(void*);
+  void *arg;
+  int pending;            // queued and not yet started
+  struct work *next;
+};
@@ -0,0 +1,98 @@
+// ============================================================================
+// PROGRAMA DE PRUEBA DE LA RESERVA DE PÁGINAS EN CERO EN XV6
+// ============================================================================
+// Este programa mide cuánto tarda sbrk() en entregar memoria nueva. Cada
+// página de usuario tiene que llegar en cero; antes allocuvm() hacía el
+// memset() mientras el proceso esperaba. Ahora el hilo del kernel kworker
+// mantiene una reserva de páginas ya limpias y sbrk() solo las mapea,
+// mientras la reserva alcance.
+//
+// FASES:
+// 1. Ráfagas cortas: pedir SHORT páginas, devolverlas y dormir un poco
+//    para que kworker rellene la reserva (casi todo sale de la reserva)
+// 2. Una ráfaga larga de LONG páginas seguidas: la reserva se agota y
+//    el resto se limpia en el momento
+//
+// MÉTRICAS:
+// - Microsegundos por página en cada fase (clock())
+//
+// CÓMO USARLO:
+// 1. Ejecutar en xv6: $ zerotest [LONG]
+// 2. Por defecto LONG = 1024 páginas (4 MB)
+// ============================================================================
+
+#include "types.h"
+#include "stat.h"
+#include "user.h"
+#include "sysinfo.h"
+
+#define PGSIZE 4096
+#define SHORT 16
+#define ROUNDS 8
+#define DEFAULT_LONG 1024
+
+int
+now_us(void)
+{
+  struct clockval cv;
+
+  clock(&cv);
+  return cv.sec * 1000000 + cv.nsec / 1000;
+}
+
+// Pide n páginas de a una y devuelve el tiempo en us, o -1 si falla
+int
+grow(int n)
+{
+  int i, start;
+
+  start = now_us();
+  for(i = 0; i < n; i++)
+    if(sbrk(PGSIZE) == (char*)-1)
+      return -1;
+  return now_us() - start;
+}
+
+int
+main(int argc, char *argv[])
+{
+  int n, r, us, total;
+
+  n = DEFAULT_LONG;
+  if(argc > 1)
+    n = atoi(argv[1]);
+  if(n <= 0){
+    printf(1, "uso: zerotest [LONG]\n");
+    exit();
+  }
+
+  printf(1, "\n");
+  printf(1, "========================================\n");
+  printf(1, "PRUEBA DE PAGINAS EN CERO - xv6\n");
+  printf(1, "========================================\n");
+
+  // FASE 1: Ráfagas cortas con pausa
+  total = 0;
+  for(r = 0; r < ROUNDS; r++){
+    sleep(5);
+    if((us = grow(SHORT)) < 0){
+      printf(1, "[ERROR] sbrk fallo\n");
+      exit();
+    }
+    total += us;
+    sbrk(-SHORT * PGSIZE);
+  }
+  printf(1, "Rafagas de %d paginas: %d us por pagina\n",
+         SHORT, total / (ROUNDS * SHORT));
+
+  // FASE 2: Ráfaga larga
+  sleep(5);
+  if((us = grow(n)) < 0){
+    printf(1, "[ERROR] sbrk fallo (sin memoria)\n");
+    exit();
+  }
+  printf(1, "Rafaga de %d paginas: %d us por pagina\n", n, us / n);
+  sbrk(-n * PGSIZE);
+  printf(1, "========================================\n");
+  exit();
+}